@@ -0,0 +1,176 @@
+""" Glyph formats on real MDI icons: size of raw (0), byte-pair RLE (1) and row bit runs (2),
+and decode throughput of the device decoders for RLE and bit runs.
+
+Glyphs are rendered by the integration's GlyphProvider (needs Pillow), the decoders are
+the ones of decode_glyph_ compiled with the host compiler (c++ or $CXX).
+
+Usage: python3 bench/glyph_codec.py [icons]
+"""
+import importlib, os, pathlib, struct, subprocess, sys, tempfile, types
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+
+SIZES = (30, 48, 64)
+
+SOURCE = r"""
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define GLYPH_FMT_RLE 1
+#define GLYPH_FMT_BITRUN 2
+
+static void set_bits_(uint8_t* to, uint32_t start, uint32_t count) {
+    uint32_t end = start + count;
+    while ((start & 7) && (start < end)) {
+        to[start >> 3] |= 0x80 >> (start & 7);
+        start++;
+    }
+    uint32_t bytes = (end - start) >> 3;
+    memset(&to[start >> 3], 0xFF, bytes);
+    start += bytes << 3;
+    while (start < end) {
+        to[start >> 3] |= 0x80 >> (start & 7);
+        start++;
+    }
+}
+
+static uint32_t read_varint_(const uint8_t* data, uint32_t len, uint32_t* pos) {
+    uint32_t result = 0;
+    for (int shift = 0; (*pos < len) && (shift < 32); shift += 7) {
+        uint8_t b = data[(*pos)++];
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) break;
+    }
+    return result;
+}
+
+static void decode_glyph_(uint8_t fmt, const uint8_t* data, uint32_t len, uint8_t box_w, uint8_t box_h, uint8_t* to, uint32_t to_len) {
+    uint32_t j = 0;
+    if (fmt == GLYPH_FMT_BITRUN) {
+        memset(to, 0, to_len);
+        uint32_t i = 0;
+        for (uint32_t row = 0; (row < box_h) && (i < len); row++) {
+            uint32_t row_len = read_varint_(data, len, &i);
+            uint32_t end = std::min(i + row_len, len);
+            uint32_t bit = row * box_w;
+            uint32_t row_end = std::min(bit + box_w, to_len * 8);
+            bool ones = false;
+            while ((i < end) && (bit < row_end)) {
+                uint32_t run = std::min(read_varint_(data, end, &i), row_end - bit);
+                if (ones) set_bits_(to, bit, run);
+                bit += run;
+                ones = !ones;
+            }
+            i = end;
+        }
+        return;
+    }
+    if (fmt == GLYPH_FMT_RLE) {
+        for (uint32_t i = 0; (i + 1 < len) && (j < to_len); i += 2) {
+            uint32_t count = std::min((uint32_t)data[i], to_len - j);
+            memset(&to[j], data[i + 1], count);
+            j += count;
+        }
+    }
+    if (j < to_len) memset(&to[j], 0, to_len - j);
+}
+
+typedef struct {
+    uint8_t box_w, box_h;
+    std::vector<uint8_t> raw, data[3];
+} Glyph;
+
+int main(int argc, char** argv) {
+    FILE* f = fopen(argv[1], "rb");
+    std::vector<Glyph> glyphs;
+    uint8_t head[2];
+    while (fread(head, 1, 2, f) == 2) {
+        Glyph glyph;
+        glyph.box_w = head[0];
+        glyph.box_h = head[1];
+        for (int fmt = 0; fmt < 3; fmt++) {
+            uint16_t len;
+            if (fread(&len, 2, 1, f) != 1) return 1;
+            glyph.data[fmt].resize(len);
+            if (len && fread(glyph.data[fmt].data(), 1, len, f) != len) return 1;
+        }
+        glyphs.push_back(glyph);
+    }
+    fclose(f);
+    std::vector<uint8_t> to(8192);
+    for (int fmt = 1; fmt < 3; fmt++) {
+        uint32_t errors = 0;
+        for (auto &glyph : glyphs) {
+            uint32_t to_len = glyph.data[0].size();
+            decode_glyph_(fmt, glyph.data[fmt].data(), glyph.data[fmt].size(), glyph.box_w, glyph.box_h, to.data(), to_len);
+            if (memcmp(to.data(), glyph.data[0].data(), to_len) != 0) errors++;
+        }
+        uint64_t bytes = 0;
+        int rounds = 0;
+        auto started = std::chrono::steady_clock::now();
+        double s = 0;
+        while (s < 0.5) {
+            for (auto &glyph : glyphs) {
+                uint32_t to_len = glyph.data[0].size();
+                decode_glyph_(fmt, glyph.data[fmt].data(), glyph.data[fmt].size(), glyph.box_w, glyph.box_h, to.data(), to_len);
+                bytes += to_len;
+            }
+            rounds++;
+            s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+        printf("%-8s %10.1f MB/s %8.2f us/glyph %6u mismatches\n", fmt == 1? "rle": "bitrun",
+            bytes / s / 1e6, s * 1e6 / (rounds * glyphs.size()), errors);
+    }
+    return 0;
+}
+"""
+
+def load_mdi_font():
+    """ Imports mdi_font as a subpackage without running the integration's __init__ (Home Assistant) """
+    package = types.ModuleType("lvgl_dashboard")
+    package.__path__ = [str(ROOT / "custom_components" / "lvgl_dashboard")]
+    sys.modules["lvgl_dashboard"] = package
+    return importlib.import_module("lvgl_dashboard.mdi_font")
+
+def main():
+    mdi_font = load_mdi_font()
+    compress = sys.modules["lvgl_dashboard.mdi_font.compress"]
+    provider = mdi_font.GlyphProvider()
+    provider.init()
+    names = sorted(provider._glyph_map)
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 300
+    names = names[::max(len(names) // count, 1)][:count]
+    blob = bytearray()
+    print(f"{len(names)} icons")
+    print(f"{'size':>5} {'raw':>8} {'rle':>8} {'bitrun':>8} {'best':>8} {'rle %':>6} {'bitrun %':>9} {'best %':>7}")
+    for size in SIZES:
+        totals = [0, 0, 0, 0]
+        for name in names:
+            info = provider.get_glyph(name, size)
+            encoded = [info.data, compress.rle_encode(info.data), compress.bitrun_encode(info.data, info.width, info.height)]
+            for fmt, data in enumerate(encoded):
+                totals[fmt] += len(data)
+            # What get_icon_value sends
+            totals[3] += min(len(data) for data in encoded)
+            blob.extend(bytes([info.width, info.height]))
+            for data in encoded:
+                blob.extend(struct.pack("<H", len(data)) + bytes(data))
+        raw = totals[0]
+        print(f"{size:>5} {totals[0]:>8} {totals[1]:>8} {totals[2]:>8} {totals[3]:>8} "
+              f"{totals[1] * 100 / raw:>6.1f} {totals[2] * 100 / raw:>9.1f} {totals[3] * 100 / raw:>7.1f}")
+    with tempfile.TemporaryDirectory() as tmp:
+        source = pathlib.Path(tmp) / "glyph_codec.cpp"
+        binary = pathlib.Path(tmp) / "glyph_codec"
+        glyphs = pathlib.Path(tmp) / "glyphs.bin"
+        source.write_text(SOURCE)
+        glyphs.write_bytes(blob)
+        subprocess.run([os.environ.get("CXX", "c++"), "-O2", "-std=c++17", "-o", str(binary), str(source)], check=True)
+        print("decode, all sizes:")
+        subprocess.run([str(binary), str(glyphs)], check=True)
+
+if __name__ == "__main__":
+    main()
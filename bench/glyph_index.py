@@ -0,0 +1,134 @@
+""" Glyph lookup of MdiFont: the former std::map of separately allocated glyph buffers
+against the direct index of packed descriptors into one bitmap slab.
+
+Both variants are compiled from the C++ below with the host compiler (c++ or $CXX),
+every draw looks a glyph up twice like LVGL does (create_glyph_dsc, then get_glyph_data).
+
+Usage: python3 bench/glyph_index.py [glyphs] [draws]
+"""
+import os, pathlib, subprocess, sys, tempfile
+
+SOURCE = r"""
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#define ICON_FONT_CODE_START 0xE000
+#define ICON_HEADER 5
+
+typedef struct {
+    uint32_t bitmap;
+    uint16_t size;
+    uint8_t fmt;
+    uint8_t ofs_x;
+    uint8_t ofs_y;
+    uint8_t box_w;
+    uint8_t box_h;
+} GlyphDsc;
+
+// Before: one heap buffer per glyph, header followed by the bitmap
+struct MapFont {
+    std::map<uint32_t, uint8_t*> glyphs;
+
+    void add(uint32_t code, uint8_t box, uint32_t size) {
+        uint8_t* data = (uint8_t*) malloc(ICON_HEADER + size);
+        data[0] = 0; data[1] = 0; data[2] = box; data[3] = box; data[4] = 0;
+        memset(data + ICON_HEADER, (uint8_t) code, size);
+        glyphs[code] = data;
+    }
+    bool dsc(uint32_t code, uint32_t* box_w) {
+        auto it = glyphs.find(code);
+        if (it == glyphs.end()) return false;
+        *box_w = it->second[2];
+        return true;
+    }
+    const uint8_t* bitmap(uint32_t code) {
+        auto it = glyphs.find(code);
+        return it == glyphs.end()? 0: it->second + ICON_HEADER;
+    }
+};
+
+// After: dense codes index packed descriptors, bitmaps share one slab
+struct SlabFont {
+    std::vector<GlyphDsc> glyphs;
+    std::vector<uint8_t> slab;
+
+    void add(uint32_t code, uint8_t box, uint32_t size) {
+        glyphs.push_back({(uint32_t) slab.size(), (uint16_t) size, 0, 0, 0, box, box});
+        slab.resize(slab.size() + size, (uint8_t) code);
+    }
+    const GlyphDsc* find(uint32_t code) {
+        uint32_t index = code - ICON_FONT_CODE_START;
+        return index < glyphs.size()? &glyphs[index]: 0;
+    }
+    bool dsc(uint32_t code, uint32_t* box_w) {
+        const auto* glyph = find(code);
+        if (glyph == 0) return false;
+        *box_w = glyph->box_w;
+        return true;
+    }
+    const uint8_t* bitmap(uint32_t code) {
+        const auto* glyph = find(code);
+        return glyph == 0? 0: &slab[glyph->bitmap];
+    }
+};
+
+template <typename Font>
+static double run(Font &font, const std::vector<uint32_t> &draws) {
+    uint32_t sink = 0;
+    auto started = std::chrono::steady_clock::now();
+    for (uint32_t code : draws) {
+        uint32_t box_w = 0;
+        if (font.dsc(code, &box_w)) sink += box_w + *font.bitmap(code);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+    if (sink == 1) printf("\n");
+    return ns / draws.size();
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = atoi(argv[1]);
+    uint32_t total = atoi(argv[2]);
+    std::mt19937 rng(1);
+    MapFont map_font;
+    SlabFont slab_font;
+    std::vector<void*> others;
+    // Registered in a mixed order of sizes, as pages arrive
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t box = (rng() % 2)? 30: 48;
+        uint32_t size = (box * box + 7) / 8;
+        map_font.add(ICON_FONT_CODE_START + i, box, size);
+        slab_font.add(ICON_FONT_CODE_START + i, box, size);
+        // Other allocations in between, like on the device
+        if (i % 3 == 0) others.push_back(malloc(64 + rng() % 512));
+    }
+    std::vector<uint32_t> draws(total);
+    for (auto &code : draws) code = ICON_FONT_CODE_START + rng() % count;
+    run(map_font, draws);
+    run(slab_font, draws);
+    double map_ns = run(map_font, draws);
+    double slab_ns = run(slab_font, draws);
+    printf("%8u %10.2f %10.2f %8.1fx\n", count, map_ns, slab_ns, map_ns / slab_ns);
+    return 0;
+}
+"""
+
+def main():
+    counts = [int(sys.argv[1])] if len(sys.argv) > 1 else [16, 64, 256, 1024]
+    draws = int(sys.argv[2]) if len(sys.argv) > 2 else 2000000
+    with tempfile.TemporaryDirectory() as tmp:
+        source = pathlib.Path(tmp) / "glyph_index.cpp"
+        binary = pathlib.Path(tmp) / "glyph_index"
+        source.write_text(SOURCE)
+        subprocess.run([os.environ.get("CXX", "c++"), "-O2", "-std=c++17", "-o", str(binary), str(source)], check=True)
+        print(f"{'glyphs':>8} {'map ns':>10} {'slab ns':>10} {'speedup':>9}")
+        for count in counts:
+            subprocess.run([str(binary), str(count), str(draws)], check=True)
+
+if __name__ == "__main__":
+    main()
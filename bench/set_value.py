@@ -0,0 +1,67 @@
+""" Payload size and encode time of set_value (JSON) against set_value_bin (MessagePack).
+
+Device side parse times are logged by the firmware (LvglDashboard::update, debug level).
+
+Usage: python3 bench/set_value.py
+"""
+import importlib.util, json, pathlib, timeit
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+
+def load(name: str, path: str):
+    """ Loads a module of the integration without importing Home Assistant """
+    spec = importlib.util.spec_from_file_location(name, ROOT / path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+encoding = load("encoding", "custom_components/lvgl_dashboard/encoding.py")
+
+ICON = {"name": "mdi:lightbulb", "size": 48, "h": 2846379011}
+
+PAYLOADS = {
+    "button": {
+        "name": "Living room", "icon": ICON, "ctype": "button", "col": "#ffc107", "font": "n",
+    },
+    "tile": {
+        "name": "Kitchen", "icon": ICON, "value": "On", "col": "#ffc107",
+        "v": False, "f": "b", "t": True, "ctype": "text", "badge": "#4caf50",
+    },
+    "layout": {
+        "ctype": "button", "col": "#263238", "cols": [1, 1, 1], "rows": [1, 1],
+        "items": [
+            {"ctype": "button" if i % 2 else "text", "x": i % 3, "y": i // 3, "w": 1, "h": 1,
+             "col": "#ffc107" if i % 2 else "#9e9e9e", "p": 0, "shp": "cl" if i % 2 else "", "r": 20, "font": "n",
+             "icon": dict(ICON, size=30)}
+            for i in range(6)
+        ],
+    },
+}
+
+def wire_size(ints: list) -> int:
+    """ Bytes of a packed repeated sint32 (zigzag varints) in the API frame """
+    result = 0
+    for value in ints:
+        value = ((value << 1) ^ (value >> 31)) & 0xffffffff
+        result += 1
+        while value >= 0x80:
+            value >>= 7
+            result += 1
+    return result
+
+def main():
+    print(f"{'payload':10} {'json':>6} {'msgpack':>8} {'wire':>6} {'json us':>8} {'msgpack us':>11}")
+    batch = []
+    for name, op in PAYLOADS.items():
+        batch.append([1, len(batch), encoding.to_binary_value(op)])
+        text = json.dumps(op)
+        data = encoding.msgpack_encode(encoding.to_binary_value(op))
+        json_us = timeit.timeit(lambda: json.dumps(op), number=2000) / 2000 * 1e6
+        msgpack_us = timeit.timeit(lambda: encoding.bytes_to_ints(encoding.msgpack_encode(encoding.to_binary_value(op))), number=2000) / 2000 * 1e6
+        print(f"{name:10} {len(text):6} {len(data):8} {wire_size(encoding.bytes_to_ints(data)):6} {json_us:8.1f} {msgpack_us:11.1f}")
+    text = json.dumps({"v": [[p, i, PAYLOADS[n]] for (p, i, _), n in zip(batch, PAYLOADS)]})
+    data = encoding.msgpack_encode({"v": batch})
+    print(f"{'batch':10} {len(text):6} {len(data):8} {wire_size(encoding.bytes_to_ints(data)):6}")
+
+if __name__ == "__main__":
+    main()
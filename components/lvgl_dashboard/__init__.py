@@ -2,13 +2,19 @@ from esphome import pins
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import lvgl, font, api, switch, rtttl
+from esphome.core import ID
 
 from esphome.const import (
     CONF_ID,
+    CONF_FILE,
+    CONF_SIZE,
 )
 
+import json, pathlib
+
 _ns = cg.esphome_ns.namespace("lvgl_dashboard")
 _cls = _ns.class_("LvglDashboard", cg.PollingComponent)
+_static_glyph = _ns.struct("StaticGlyph")
 
 CODEOWNERS = ["@kvj"]
 DEPENDENCIES = ["lvgl", "font", "api", "switch", "rtttl"]
@@ -35,6 +41,14 @@ CONF_VERTICAL = "vertical"
 CONF_COMPONENTS = "components"
 CONF_TYPE = "type"
 CONF_LITTLE_ENDIAN = "little_endian"
+CONF_UPDATE_BUDGET = "update_budget"
+CONF_MAX_PAGES = "max_pages"
+CONF_MIN_FREE_HEAP = "min_free_heap"
+CONF_ICONS = "icons"
+CONF_JPEG = "jpeg"
+CONF_META = "meta"
+CONF_GLYPHS = "glyphs"
+CONF_NAMES = "names"
 
 DASHBOARD_RESET_DEF = 10
 
@@ -43,6 +57,20 @@ BUTTON_CMP = cv.Schema({
     cv.Optional(CONF_TYPE, default="switch"): cv.string,
 })
 
+def _icon_name(value):
+    value = cv.string_strict(value)
+    return value[4:] if value.startswith("mdi:") else value
+
+ICONS_SCHEMA = cv.Schema({
+    cv.Required(CONF_FILE): cv.file_,
+    # Defaults to meta.json next to the font file
+    cv.Optional(CONF_META): cv.file_,
+    cv.Required(CONF_GLYPHS): cv.ensure_list(cv.Schema({
+        cv.Required(CONF_SIZE): cv.int_range(min=1, max=255),
+        cv.Required(CONF_NAMES): cv.ensure_list(_icon_name),
+    })),
+})
+
 CONFIG_SCHEMA = (
     cv.Schema({
         cv.GenerateID(): cv.declare_id(_cls),
@@ -62,12 +90,65 @@ CONFIG_SCHEMA = (
         cv.Optional(CONF_VERTICAL, default=False): cv.boolean,
         cv.Optional(CONF_LITTLE_ENDIAN, default=False): cv.boolean,
         cv.Optional(CONF_DASHBOARD_RESET, default=DASHBOARD_RESET_DEF): cv.positive_int,
+        cv.Optional(CONF_UPDATE_BUDGET, default="10ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_PAGES, default=0): cv.positive_int,
+        cv.Optional(CONF_MIN_FREE_HEAP, default=0): cv.positive_int,
         cv.Optional(CONF_COMPONENTS, default=[]): cv.ensure_list(cv.use_id(cg.Component)),
+        cv.Optional(CONF_ICONS): ICONS_SCHEMA,
+        cv.Optional(CONF_JPEG, default=False): cv.boolean,
     })
     .extend(cv.polling_component_schema("15s"))
 )
 
 
+def _rasterize_icon(ttf_font, glyph: str, size: int):
+    # Same 1bpp rendering as GlyphProvider.get_glyph() of the integration
+    mask = ttf_font.getmask(glyph, mode="1")
+    _, (offset_x, offset_y) = ttf_font.font.getsize(glyph)
+    width, height = mask.size
+    data = [0] * ((width * height + 7) // 8)
+    pos = 0
+    for y in range(height):
+        for x in range(width):
+            if mask.getpixel((x, y)):
+                data[pos // 8] |= 0x80 >> (pos % 8)
+            pos += 1
+    return offset_x, offset_y, width, height, data
+
+def _icons_to_code(var, config):
+    from PIL import ImageFont
+
+    path = pathlib.Path(config[CONF_FILE])
+    meta_path = pathlib.Path(config[CONF_META]) if CONF_META in config else path.parent.joinpath("meta.json")
+    codepoints = {}
+    for item in json.loads(meta_path.read_text()):
+        codepoint = chr(int(item["codepoint"], 16))
+        codepoints[item["name"]] = codepoint
+        for a in item.get("aliases", []):
+            codepoints.setdefault(a, codepoint)
+    for conf in config[CONF_GLYPHS]:
+        size = conf[CONF_SIZE]
+        ttf_font = ImageFont.truetype(str(path), size)
+        bitmaps = []
+        glyphs = []
+        # MdiFont looks names up with a binary search
+        for name in sorted(set(conf[CONF_NAMES])):
+            if name not in codepoints:
+                raise cv.Invalid(f"Unknown icon: {name}")
+            x, y, w, h, data = _rasterize_icon(ttf_font, codepoints[name], size)
+            glyphs.append(cg.StructInitializer(
+                _static_glyph,
+                ("name", name),
+                ("bitmap", len(bitmaps)),
+                ("ofs_x", x), ("ofs_y", y), ("box_w", w), ("box_h", h),
+            ))
+            bitmaps.extend(data)
+        bitmaps_id = ID(f"{config[CONF_ID].id}_icons_{size}_data", is_declaration=True, type=cg.uint8)
+        glyphs_id = ID(f"{config[CONF_ID].id}_icons_{size}", is_declaration=True, type=_static_glyph)
+        bitmaps_ = cg.progmem_array(bitmaps_id, bitmaps)
+        glyphs_ = cg.static_const_array(glyphs_id, cg.ArrayInitializer(*glyphs))
+        cg.add(var.add_static_icons(size, glyphs_, len(glyphs), bitmaps_))
+
 async def to_code(config):
     lvgl.defines.add_define("LV_USE_GRID")
     lvgl.defines.add_define("LV_USE_FLEX")
@@ -109,9 +190,17 @@ async def to_code(config):
     if CONF_RTTTL in config:
         cg.add(var.set_rtttl(await cg.get_variable(config[CONF_RTTTL])))
     cg.add(var.set_dashboard_reset_timeout(config[CONF_DASHBOARD_RESET]))
+    cg.add(var.set_update_budget(config[CONF_UPDATE_BUDGET]))
+    cg.add(var.set_page_cache(config[CONF_MAX_PAGES], config[CONF_MIN_FREE_HEAP]))
     if CONF_DESIGN in config:
         for key, value in config[CONF_DESIGN].items():
             cg.add_define(f"LVD_{key.upper()}", cg.RawExpression(value))
     for cmp in config[CONF_COMPONENTS]:
         cg.add(var.add_component(await cg.get_variable(cmp)))
+    if config[CONF_JPEG]:
+        # Pictures may arrive as JPEG and are decoded on the device
+        cg.add_define("USE_LVD_JPEG")
+        cg.add_library("JPEGDEC", None, "https://github.com/bitbank2/JPEGDEC#ca1e0f2")
+    if CONF_ICONS in config:
+        _icons_to_code(var, {**config[CONF_ICONS], CONF_ID: config[CONF_ID]})
     await cg.register_component(var, config)
@@ -81,6 +81,117 @@ void mem_free_(void* ptr) {
     #endif
 }
 
+size_t mem_free_size_() {
+    #ifdef USE_HOST
+    return SIZE_MAX;
+    #else
+    return heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    #endif
+}
+
+static BufferPool image_buffers_;
+
+// Rounded up to an eighth of its power of two, at most 12.5% over the size
+uint32_t BufferPool::size_class(uint32_t size) {
+    if (size <= LVD_BUFFER_POOL_MIN_CLASS) return LVD_BUFFER_POOL_MIN_CLASS;
+    uint32_t top = 31 - __builtin_clz(size);
+    uint32_t step = top > 3? (1u << (top - 3)): 1;
+    return (size + step - 1) & ~(step - 1);
+}
+
+uint8_t* BufferPool::acquire(uint32_t size) {
+    uint32_t size_class = BufferPool::size_class(size);
+    if (auto search = this->free_.find(size_class); (search != this->free_.end()) && !search->second.empty()) {
+        uint8_t* data = search->second.back();
+        search->second.pop_back();
+        this->held_ -= size_class;
+        this->hits_++;
+        return data;
+    }
+    this->misses_++;
+    ESP_LOGD(TAG, "BufferPool::acquire: %u (%u), hits: %u, misses: %u, held: %u", size, size_class, this->hits_, this->misses_, this->held_);
+    uint8_t* data = mem_alloc_(size_class);
+    if ((data == 0) && (this->held_ > 0)) {
+        // Pooled buffers of other classes give way to the one needed now
+        this->trim(0);
+        data = mem_alloc_(size_class);
+    }
+    return data;
+}
+
+void BufferPool::release(uint8_t* data, uint32_t size) {
+    uint32_t size_class = BufferPool::size_class(size);
+    if (this->held_ + size_class > LVD_BUFFER_POOL_BYTES) {
+        mem_free_(data);
+        return;
+    }
+    this->free_[size_class].push_back(data);
+    this->held_ += size_class;
+}
+
+// Frees pooled buffers, largest first, until at most bytes are held
+void BufferPool::trim(uint32_t bytes) {
+    for (auto it = this->free_.rbegin(); (it != this->free_.rend()) && (this->held_ > bytes); it++) {
+        while (!it->second.empty() && (this->held_ > bytes)) {
+            mem_free_(it->second.back());
+            it->second.pop_back();
+            this->held_ -= it->first;
+        }
+    }
+    ESP_LOGD(TAG, "BufferPool::trim: %u, hits: %u, misses: %u, held: %u", bytes, this->hits_, this->misses_, this->held_);
+}
+
+PageArena::~PageArena() {
+    this->reset();
+    for (auto* block : this->blocks_) {
+        mem_free_(block);
+    }
+    this->blocks_.clear();
+}
+
+void* PageArena::allocate(size_t size, size_t align) {
+    auto aligned = [this, align](uint8_t* block) -> size_t {
+        uintptr_t base = (uintptr_t)block;
+        return ((base + this->used_ + align - 1) & ~(uintptr_t)(align - 1)) - base;
+    };
+    size_t offset = this->blocks_.empty()? 0: aligned(this->blocks_.back());
+    if (!this->blocks_.empty() && (offset + size <= LVD_PAGE_ARENA_BLOCK)) {
+        this->used_ = offset + size;
+        return this->blocks_.back() + offset;
+    }
+    if (size + align > LVD_PAGE_ARENA_BLOCK) {
+        // Dedicated block, the current one stays open
+        auto* block = mem_alloc_(size + align);
+        if (block == 0) return 0;
+        if (this->blocks_.empty()) {
+            this->blocks_.push_back(block);
+            this->used_ = LVD_PAGE_ARENA_BLOCK;
+        } else {
+            this->blocks_.insert(this->blocks_.end() - 1, block);
+        }
+        uintptr_t base = (uintptr_t)block;
+        return block + (((base + align - 1) & ~(uintptr_t)(align - 1)) - base);
+    }
+    auto* block = mem_alloc_(LVD_PAGE_ARENA_BLOCK);
+    if (block == 0) return 0;
+    this->blocks_.push_back(block);
+    this->used_ = 0;
+    offset = aligned(block);
+    this->used_ = offset + size;
+    return block + offset;
+}
+
+// Keeps the first block for the next build of the page
+void PageArena::reset() {
+    for (int i = 1; i < this->blocks_.size(); i++) {
+        mem_free_(this->blocks_[i]);
+    }
+    if (this->blocks_.size() > 1) {
+        this->blocks_.resize(1);
+    }
+    this->used_ = 0;
+}
+
 struct SpiRamAllocator {
     void* allocate(size_t size) {
         return mem_alloc_(size);
@@ -98,28 +209,113 @@ struct SpiRamAllocator {
 
 using SpiRamJsonDocument = BasicJsonDocument<SpiRamAllocator>;
 
-bool json_parse_(std::string json_doc, std::function<void(JsonObject)> &&fn) {
-    size_t doc_size = 2.5 * json_doc.size();
-    DeserializationError err;
-    do {
-        auto doc_ = SpiRamJsonDocument(doc_size);
-        if (doc_.capacity() == 0) {
-            ESP_LOGW(TAG, "json_parse_:: Failed to allocate memory for Json");
-            return false;
+#ifndef LVD_JSON_MIN_CAPACITY
+    #define LVD_JSON_MIN_CAPACITY 1024
+#endif
+
+// Largest document kept between parses, bigger ones are released after use
+#ifndef LVD_JSON_MAX_CAPACITY
+    #define LVD_JSON_MAX_CAPACITY 16384
+#endif
+
+// Persistent document, reset for every parse and only grown when an input does not fit.
+// Released after an input that pushed it over LVD_JSON_MAX_CAPACITY.
+static SpiRamJsonDocument* json_doc_ = 0;
+static size_t json_high_water_ = 0;
+static bool json_busy_ = false;
+
+// Parse time per input format (JSON, MessagePack), logged by LvglDashboard::update()
+typedef struct {
+    uint32_t count;
+    uint32_t bytes;
+    uint32_t us;
+} JsonParseStats;
+static JsonParseStats json_stats_[2] = {};
+
+static void json_parse_time_(bool msgpack, size_t len, uint32_t started) {
+    auto &stats = json_stats_[msgpack? 1: 0];
+    uint32_t us = esphome::micros() - started;
+    stats.count++;
+    stats.bytes += len;
+    stats.us += us;
+    ESP_LOGV(TAG, "json_parse_: %s: %u bytes in %u us", msgpack? "msgpack": "json", len, us);
+}
+
+static DeserializationError json_deserialize_(SpiRamJsonDocument* &doc, const char* json, size_t len, bool msgpack) {
+    size_t doc_size = std::max((size_t)(2.5 * len), (size_t)LVD_JSON_MIN_CAPACITY);
+    if ((doc != 0) && (doc->capacity() < doc_size)) {
+        delete doc;
+        doc = 0;
+    }
+    while (true) {
+        if (doc == 0) {
+            doc = new SpiRamJsonDocument(doc_size);
+            if (doc->capacity() == 0) {
+                ESP_LOGW(TAG, "json_parse_:: Failed to allocate memory for Json: %u", doc_size);
+                delete doc;
+                doc = 0;
+                return DeserializationError::NoMemory;
+            }
+        }
+        doc->clear();
+        auto err = msgpack? deserializeMsgPack(*doc, json, len): deserializeJson(*doc, json, len);
+        if (err != DeserializationError::NoMemory) {
+            return err;
         }
-        err = deserializeJson(doc_, json_doc);
-        doc_.shrinkToFit();
-        JsonObject root = doc_.as<JsonObject>();
+        doc_size = doc->capacity() * 2;
+        delete doc;
+        doc = 0;
+    }
+}
+
+static bool json_parse_(const char* json, size_t len, bool msgpack, std::function<void(JsonObject)> &&fn) {
+    uint32_t started = esphome::micros();
+    if (json_busy_) {
+        // Nested parse: the shared document is in use
+        SpiRamJsonDocument* doc = 0;
+        auto err = json_deserialize_(doc, json, len, msgpack);
         if (err == DeserializationError::Ok) {
-            ESP_LOGV(TAG, "json_parse_: Deserialized: %u / %u", json_doc.size(), doc_size);
-            fn(root);
-            return true;
+            json_parse_time_(msgpack, len, started);
+            fn(doc->as<JsonObject>());
         } else {
-            ESP_LOGD(TAG, "json_parse_:: Failed to deserialize Json: %u [%s]", json_doc.size(), err.c_str());
+            ESP_LOGD(TAG, "json_parse_:: Failed to deserialize Json: %u [%s]", len, err.c_str());
         }
-        doc_size *= 2;
-    } while (err == DeserializationError::NoMemory);
-    return false;
+        if (doc != 0) delete doc;
+        return err == DeserializationError::Ok;
+    }
+    auto err = json_deserialize_(json_doc_, json, len, msgpack);
+    if (err != DeserializationError::Ok) {
+        ESP_LOGD(TAG, "json_parse_:: Failed to deserialize Json: %u [%s]", len, err.c_str());
+        return false;
+    }
+    json_parse_time_(msgpack, len, started);
+    if (json_doc_->memoryUsage() > json_high_water_) {
+        json_high_water_ = json_doc_->memoryUsage();
+        ESP_LOGD(TAG, "json_parse_: high-water mark: %u / %u (input %u)", json_high_water_, json_doc_->capacity(), len);
+    }
+    ESP_LOGV(TAG, "json_parse_: Deserialized: %u / %u", len, json_doc_->memoryUsage());
+    json_busy_ = true;
+    fn(json_doc_->as<JsonObject>());
+    json_busy_ = false;
+    if (json_doc_->capacity() > LVD_JSON_MAX_CAPACITY) {
+        ESP_LOGD(TAG, "json_parse_: releasing oversized document: %u", json_doc_->capacity());
+        delete json_doc_;
+        json_doc_ = 0;
+    }
+    return true;
+}
+
+bool json_parse_(const char* json, size_t len, std::function<void(JsonObject)> &&fn) {
+    return json_parse_(json, len, false, std::move(fn));
+}
+
+bool json_parse_(const std::string &json_doc, std::function<void(JsonObject)> &&fn) {
+    return json_parse_(json_doc.data(), json_doc.size(), false, std::move(fn));
+}
+
+// MessagePack payloads arrive over the int[] transport, packed 4 bytes per value
+bool msgpack_parse_(const uint8_t* data, size_t len, std::function<void(JsonObject)> &&fn) {
+    return json_parse_((const char*)data, len, true, std::move(fn));
 }
 
 static const uint8_t *_mdi_get_glyph_bitmap(const lv_font_t *font, uint32_t unicode_letter) {
@@ -137,29 +333,325 @@ static bool _mdi_get_glyph_dsc_cb(const lv_font_t *font, lv_font_glyph_dsc_t *ds
     return true;
 }
 
+#define ICON_HEADER 5
+#define GLYPH_FMT_RAW 0
+#define GLYPH_FMT_RLE 1
+#define GLYPH_FMT_BITRUN 2
+#define GLYPH_FMT_OUTLINE 3
+// Runtime glyphs use the BMP private use area, U+E000..U+F8FF,
+// counting up from the start. Static glyphs count down from the end.
+#define ICON_FONT_CODE_START 0xE000
+#define ICON_FONT_CODE_END 0xF8FF
+
+inline const GlyphDsc* MdiFont::find_glyph_(uint32_t unicode_letter) {
+    // Codes are dense, anything below the first code wraps around
+    uint32_t index = unicode_letter - this->first_code_;
+    return index < this->glyphs_.size()? &this->glyphs_[index]: 0;
+}
+
+inline const StaticGlyph* MdiFont::find_static_(uint32_t unicode_letter) {
+    uint32_t index = ICON_FONT_CODE_END - unicode_letter;
+    return index < this->static_.count? &this->static_.glyphs[index]: 0;
+}
+
 bool MdiFont::create_glyph_dsc(uint32_t unicode_letter, lv_font_glyph_dsc_t *dsc) {
-    if (auto search = this->glyphs_.find(unicode_letter); search != this->glyphs_.end()) {
-        uint8_t* data = search->second;
-        dsc->adv_w = data[0] + data[2];
-        dsc->ofs_x = data[0];
-        dsc->ofs_y = this->size_ - data[3] - data[1];
-        dsc->box_w = data[2];
-        dsc->box_h = data[3];
-        dsc->is_placeholder = 0;
-        dsc->bpp = 1;
-        return true;
+    uint8_t ofs_x, ofs_y, box_w, box_h, bpp = 1;
+    if (const auto* glyph = this->find_glyph_(unicode_letter); glyph != 0) {
+        ofs_x = glyph->ofs_x; ofs_y = glyph->ofs_y; box_w = glyph->box_w; box_h = glyph->box_h;
+        if (glyph->fmt == GLYPH_FMT_OUTLINE) bpp = LVD_OUTLINE_BPP;
+    } else if (const auto* static_glyph = this->find_static_(unicode_letter); static_glyph != 0) {
+        ofs_x = static_glyph->ofs_x; ofs_y = static_glyph->ofs_y; box_w = static_glyph->box_w; box_h = static_glyph->box_h;
+    } else {
+        return false;
     }
-    return false;
+    dsc->adv_w = ofs_x + box_w;
+    dsc->ofs_x = ofs_x;
+    dsc->ofs_y = this->size_ - box_h - ofs_y;
+    dsc->box_w = box_w;
+    dsc->box_h = box_h;
+    dsc->is_placeholder = 0;
+    dsc->bpp = bpp;
+    return true;
 }
 
-const uint8_t* MdiFont::get_glyph_data(uint32_t unicode_letter) {
-    if (auto search = this->glyphs_.find(unicode_letter); search != this->glyphs_.end()) {
-        uint8_t* data = search->second;
-        return &data[5];
+static GlyphCache glyph_cache_;
+
+void GlyphCache::evict_(GlyphCacheEntry* entry) {
+    if (entry->data != 0) {
+        mem_free_(entry->data);
+        this->bytes_ -= entry->size;
+    }
+    *entry = {};
+}
+
+uint8_t* GlyphCache::find(const void* font, uint32_t code) {
+    for (auto &entry : this->entries_) {
+        if ((entry.data != 0) && (entry.font == font) && (entry.code == code)) {
+            entry.used = ++this->clock_;
+            this->hits_++;
+            return entry.data;
+        }
     }
+    this->misses_++;
     return 0;
 }
 
+// The returned bitmap stays valid until the next insert, LVGL draws a letter before fetching the next one
+uint8_t* GlyphCache::insert(const void* font, uint32_t code, uint32_t size) {
+    // Never fits, evicting would only flush the cache on every draw
+    if (size > LVD_GLYPH_CACHE_BYTES) return 0;
+    while (true) {
+        GlyphCacheEntry* lru = 0;
+        GlyphCacheEntry* free_ = 0;
+        for (auto &entry : this->entries_) {
+            if (entry.data == 0) {
+                free_ = &entry;
+            } else if ((lru == 0) || (entry.used < lru->used)) {
+                lru = &entry;
+            }
+        }
+        if ((free_ != 0) && (this->bytes_ + size <= LVD_GLYPH_CACHE_BYTES)) {
+            free_->data = mem_alloc_(size);
+            if (free_->data == 0) return 0;
+            free_->font = font;
+            free_->code = code;
+            free_->size = size;
+            free_->used = ++this->clock_;
+            this->bytes_ += size;
+            return free_->data;
+        }
+        if (lru == 0) return 0;
+        this->evict_(lru);
+        this->evictions_++;
+    }
+}
+
+// Same lifetime as an inserted bitmap, only valid until the next glyph is fetched
+uint8_t* GlyphCache::scratch(uint32_t size) {
+    if (size > this->scratch_size_) {
+        auto* scratch = mem_realloc_(this->scratch_, size);
+        if (scratch == 0) {
+            ESP_LOGW(TAG, "GlyphCache::scratch: Failed to allocate: %u", size);
+            return 0;
+        }
+        this->scratch_ = scratch;
+        this->scratch_size_ = size;
+    }
+    return this->scratch_;
+}
+
+void GlyphCache::drop(const void* font) {
+    for (auto &entry : this->entries_) {
+        if (entry.font == font) this->evict_(&entry);
+    }
+}
+
+// Sets count bits from start (MSB first), whole bytes with memset
+static void set_bits_(uint8_t* to, uint32_t start, uint32_t count) {
+    uint32_t end = start + count;
+    while ((start & 7) && (start < end)) {
+        to[start >> 3] |= 0x80 >> (start & 7);
+        start++;
+    }
+    uint32_t bytes = (end - start) >> 3;
+    memset(&to[start >> 3], 0xFF, bytes);
+    start += bytes << 3;
+    while (start < end) {
+        to[start >> 3] |= 0x80 >> (start & 7);
+        start++;
+    }
+}
+
+static uint32_t read_varint_(const uint8_t* data, uint32_t len, uint32_t* pos) {
+    uint32_t result = 0;
+    for (int shift = 0; (*pos < len) && (shift < 32); shift += 7) {
+        uint8_t b = data[(*pos)++];
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) break;
+    }
+    return result;
+}
+
+static void decode_glyph_(uint8_t fmt, const uint8_t* data, uint32_t len, uint8_t box_w, uint8_t box_h, uint8_t* to, uint32_t to_len) {
+    uint32_t j = 0;
+    if (fmt == GLYPH_FMT_BITRUN) {
+        // Per row its byte length, then alternating 0/1 run lengths starting with 0, all varints.
+        // Runs restart at every row and the trailing 0 run is implied, a row is reached by skipping lengths
+        memset(to, 0, to_len);
+        uint32_t i = 0;
+        for (uint32_t row = 0; (row < box_h) && (i < len); row++) {
+            uint32_t row_len = read_varint_(data, len, &i);
+            uint32_t end = std::min(i + row_len, len);
+            uint32_t bit = row * box_w;
+            uint32_t row_end = std::min(bit + box_w, to_len * 8);
+            bool ones = false;
+            while ((i < end) && (bit < row_end)) {
+                uint32_t run = std::min(read_varint_(data, end, &i), row_end - bit);
+                if (ones) set_bits_(to, bit, run);
+                bit += run;
+                ones = !ones;
+            }
+            i = end;
+        }
+        return;
+    }
+    if (fmt == GLYPH_FMT_RLE) {
+        // Byte-pair RLE: count, value
+        for (uint32_t i = 0; (i + 1 < len) && (j < to_len); i += 2) {
+            uint32_t count = std::min((uint32_t)data[i], to_len - j);
+            memset(&to[j], data[i + 1], count);
+            j += count;
+        }
+    }
+    if (j < to_len) memset(&to[j], 0, to_len - j);
+}
+
+#define OUTLINE_UNITS 4095.0f
+
+typedef struct {
+    float x0, y0, x1, y1;
+} OutlineEdge;
+
+typedef struct {
+    float x, y;
+    bool on;
+} OutlinePoint;
+
+static inline int32_t unzigzag_(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// TrueType contour: quadratic segments, consecutive off curve points imply an on curve midpoint
+static void flatten_contour_(std::vector<OutlinePoint> &pts, std::vector<OutlineEdge> &edges) {
+    std::vector<OutlinePoint> seq;
+    seq.reserve(pts.size() * 2);
+    for (size_t i = 0; i < pts.size(); i++) {
+        const auto &p = pts[i];
+        const auto &next = pts[(i + 1) % pts.size()];
+        seq.push_back(p);
+        if (!p.on && !next.on) seq.push_back({(p.x + next.x) / 2, (p.y + next.y) / 2, true});
+    }
+    size_t start = 0;
+    while ((start < seq.size()) && !seq[start].on) start++;
+    if (start == seq.size()) return;
+    OutlinePoint cur = seq[start];
+    for (size_t k = 1; k <= seq.size(); k++) {
+        const auto &p = seq[(start + k) % seq.size()];
+        if (p.on) {
+            edges.push_back({cur.x, cur.y, p.x, p.y});
+            cur = p;
+            continue;
+        }
+        const auto &end = seq[(start + k + 1) % seq.size()];
+        float x = cur.x, y = cur.y;
+        for (int s = 1; s <= LVD_OUTLINE_CURVE_STEPS; s++) {
+            float t = (float)s / LVD_OUTLINE_CURVE_STEPS;
+            float u = 1 - t;
+            float nx = u * u * cur.x + 2 * u * t * p.x + t * t * end.x;
+            float ny = u * u * cur.y + 2 * u * t * p.y + t * t * end.y;
+            edges.push_back({x, y, nx, ny});
+            x = nx;
+            y = ny;
+        }
+        cur = end;
+        k++;
+    }
+}
+
+// Outline in glyph box units to an anti-aliased bitmap, non-zero winding,
+// LVD_OUTLINE_SAMPLES x LVD_OUTLINE_SAMPLES samples per pixel
+static void rasterize_outline_(const uint8_t* data, uint32_t len, uint8_t w, uint8_t h, uint8_t* to, uint32_t to_len) {
+    memset(to, 0, to_len);
+    std::vector<OutlineEdge> edges;
+    std::vector<OutlinePoint> pts;
+    uint32_t pos = 0;
+    int32_t x = 0, y = 0;
+    uint32_t contours = read_varint_(data, len, &pos);
+    for (uint32_t c = 0; (c < contours) && (pos < len); c++) {
+        uint32_t count = read_varint_(data, len, &pos);
+        pts.clear();
+        for (uint32_t i = 0; (i < count) && (pos < len); i++) {
+            uint32_t xv = read_varint_(data, len, &pos);
+            x += unzigzag_(xv >> 1);
+            y += unzigzag_(read_varint_(data, len, &pos));
+            pts.push_back({x * w / OUTLINE_UNITS, y * h / OUTLINE_UNITS, (xv & 1) != 0});
+        }
+        if (pts.size() > 1) flatten_contour_(pts, edges);
+    }
+
+    const int ss = LVD_OUTLINE_SAMPLES;
+    const uint32_t levels = (1 << LVD_OUTLINE_BPP) - 1;
+    std::vector<uint16_t> coverage(w);
+    std::vector<std::pair<float, int>> crossings;
+    for (int row = 0; row < h; row++) {
+        std::fill(coverage.begin(), coverage.end(), 0);
+        for (int sub = 0; sub < ss; sub++) {
+            float yc = row + (sub + 0.5f) / ss;
+            crossings.clear();
+            for (const auto &e : edges) {
+                if ((e.y0 <= yc) == (e.y1 <= yc)) continue;
+                float xc = e.x0 + (yc - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0);
+                crossings.push_back({xc, e.y1 > e.y0? 1: -1});
+            }
+            std::sort(crossings.begin(), crossings.end());
+            int winding = 0;
+            for (size_t i = 0; i + 1 < crossings.size(); i++) {
+                winding += crossings[i].second;
+                if (winding == 0) continue;
+                // Sample columns with centers inside the span
+                int from = std::max((int)ceilf(crossings[i].first * ss - 0.5f), 0);
+                int to_ = std::min((int)ceilf(crossings[i + 1].first * ss - 0.5f), w * ss);
+                for (int col = from; col < to_; col++) coverage[col / ss]++;
+            }
+        }
+        for (int col = 0; col < w; col++) {
+            uint32_t value = (coverage[col] * levels + ss * ss / 2) / (ss * ss);
+            if (value == 0) continue;
+            uint32_t bit = ((uint32_t)row * w + col) * LVD_OUTLINE_BPP;
+            to[bit >> 3] |= value << (8 - LVD_OUTLINE_BPP - (bit & 7));
+        }
+    }
+}
+
+// Bytes of a glyph as kept in the slab, outlines are stored rasterized
+static uint32_t stored_size_(uint8_t fmt, uint8_t box_w, uint8_t box_h, uint32_t size) {
+    return fmt == GLYPH_FMT_OUTLINE? ((uint32_t)box_w * box_h * LVD_OUTLINE_BPP + 7) / 8: size;
+}
+
+const uint8_t* MdiFont::get_glyph_data(uint32_t unicode_letter) {
+    const auto* glyph = this->find_glyph_(unicode_letter);
+    if (glyph == 0) {
+        // Static glyphs are raw and drawn straight from flash
+        const auto* static_glyph = this->find_static_(unicode_letter);
+        return static_glyph != 0? &this->static_.bitmaps[static_glyph->bitmap]: 0;
+    }
+    const uint8_t* stored = &this->slab_[glyph->bitmap];
+    if ((glyph->fmt == GLYPH_FMT_RAW) || (glyph->fmt == GLYPH_FMT_OUTLINE)) return stored;
+    uint8_t* data = glyph_cache_.find(this, unicode_letter);
+    if (data != 0) return data;
+    uint32_t size = ((uint32_t)glyph->box_w * glyph->box_h + 7) / 8;
+    data = glyph_cache_.insert(this, unicode_letter, size);
+    if (data == 0) data = glyph_cache_.scratch(size);
+    if (data == 0) return 0;
+    decode_glyph_(glyph->fmt, stored, glyph->size, glyph->box_w, glyph->box_h, data, size);
+    return data;
+}
+
+// Bitmaps are only referenced by offset, so the slab can move when it grows
+uint8_t* MdiFont::reserve_bitmap_(uint32_t size) {
+    if (this->slab_used_ + size > this->slab_size_) {
+        uint32_t slab_size = std::max(std::max(this->slab_size_ * 2, this->slab_used_ + size), (uint32_t)1024);
+        auto* slab = mem_realloc_(this->slab_, slab_size);
+        if (slab == 0) {
+            ESP_LOGW(TAG, "MdiFont::reserve_bitmap_: Failed to grow glyph slab: %u", slab_size);
+            return 0;
+        }
+        this->slab_ = slab;
+        this->slab_size_ = slab_size;
+    }
+    return &this->slab_[this->slab_used_];
+}
+
 static uint32_t get_rle_size(uint8_t* buffer, uint32_t len) {
     uint32_t result = 0;
     for (int i = 0; i < len - 1; i += 2) {
@@ -176,9 +668,6 @@ static void decompress_rle(uint8_t* buffer, uint32_t len, uint8_t* to_buffer) {
     }
 }
 
-#define ICON_HEADER 5
-#define ICON_FONT_CODE_START 0x20
-
 static uint32_t get_b64_size(uint8_t prefix, std::string b64_data) {
     auto b64_decoded = base64_decode(b64_data);
     if (b64_decoded[prefix] == 1) {
@@ -200,38 +689,166 @@ static void data_from_b64(uint8_t prefix, std::string b64_data, uint8_t* buffer)
     }
 }
 
-uint32_t MdiFont::add_glyph(std::string icon, std::string b64_data) {
-    if (auto search = this->codes_.find(icon); search != this->codes_.end()) 
-        return search->second;
-    auto b64_decoded = base64_decode(b64_data);
+static uint32_t fnv1a_(const std::string &value, uint32_t hash = 2166136261u) {
+    for (char c : value) {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash;
+}
 
-    uint16_t size = b64_decoded.size();
-    uint8_t* buf;
-    if (b64_decoded[4] == 1) {
-        // rle
-        auto rle_size = get_rle_size(b64_decoded.data() + ICON_HEADER, b64_decoded.size() - ICON_HEADER);
-        ESP_LOGD(TAG, "add_glyph: icon: %s, rle size: %lu", icon.c_str(), rle_size);
-        size = ICON_HEADER + rle_size;
-
-        buf = mem_alloc_(size);
-        memcpy(buf, b64_decoded.data(), ICON_HEADER);
-        decompress_rle(b64_decoded.data() + ICON_HEADER, b64_decoded.size() - ICON_HEADER, &buf[ICON_HEADER]);
-    } else {
-        ESP_LOGD(TAG, "add_glyph: icon: %s, raw size: %u", icon.c_str(), size);
-        buf = mem_alloc_(size);
-        memcpy(buf, b64_decoded.data(), size);
-    }
-    uint32_t code = ICON_FONT_CODE_START + this->codes_.size() + 1;
-    this->codes_[icon] = code;
-    this->glyphs_[code] = buf;
-    ESP_LOGD(TAG, "add_glyph: %u - %u - %u - %u", buf[0], buf[1], buf[2], buf[3]);
+static uint32_t fnv1a_(const uint8_t* data, uint32_t size, uint32_t hash = 2166136261u) {
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Static glyphs match by name whatever the integration rendered, the size is the font's.
+// A match is recorded with the integration's hash like a received glyph, so the digest still covers what it has sent
+uint32_t MdiFont::find_static_(const std::string &icon, uint32_t hash) {
+    int lo = 0;
+    int hi = (int)this->static_.count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const auto &glyph = this->static_.glyphs[mid];
+        int cmp = strcmp(icon.c_str(), glyph.name);
+        if (cmp == 0) {
+            uint32_t code = ICON_FONT_CODE_END - mid;
+            this->codes_[icon] = {.code = code, .hash = hash};
+            return code;
+        }
+        if (cmp < 0) hi = mid - 1; else lo = mid + 1;
+    }
+    return 0;
+}
+
+uint32_t MdiFont::find_glyph(const std::string &icon, uint32_t hash) {
+    if (auto search = this->codes_.find(icon); search != this->codes_.end()) {
+        if (search->second.hash == hash) return search->second.code;
+    }
+    return this->find_static_(icon, hash);
+}
+
+// XOR of per glyph digests, order independent and computed the same way by the integration
+uint32_t MdiFont::digest(uint32_t* count) {
+    uint32_t result = 0;
+    for (auto &it : this->codes_) {
+        result ^= fnv1a_(it.first + ":" + std::to_string(this->size_) + ":" + std::to_string(it.second.hash));
+    }
+    *count += this->codes_.size();
+    return result;
+}
+
+// "size:hash:name" per glyph, what the digest covers
+void MdiFont::append_records(std::string &result) {
+    for (auto &it : this->codes_) {
+        if (!result.empty()) result += ";";
+        result += std::to_string(this->size_) + ":" + std::to_string(it.second.hash) + ":" + it.first;
+    }
+}
+
+uint32_t MdiFont::add_glyph(std::string icon, uint32_t hash, std::string b64_data) {
+    // Same name with other content (e.g. a new MDI release) gets a new code
+    if (uint32_t code = this->find_glyph(icon, hash); code != 0) 
+        return code;
+    auto b64_decoded = base64_decode(b64_data);
+    if (b64_decoded.size() < ICON_HEADER) {
+        ESP_LOGW(TAG, "add_glyph: icon: %s, invalid size: %u", icon.c_str(), b64_decoded.size());
+        return 0;
+    }
+    return this->add_glyph_(icon, hash, b64_decoded.data(), b64_decoded.size() - ICON_HEADER);
+}
+
+// header: ofs_x, ofs_y, box_w, box_h, fmt, followed by size bytes of bitmap
+uint32_t MdiFont::add_glyph_(const std::string &icon, uint32_t hash, const uint8_t* header, uint32_t size) {
+    if (this->first_code_ + this->glyphs_.size() > ICON_FONT_CODE_END - this->static_.count) {
+        ESP_LOGW(TAG, "add_glyph: icon: %s, no free codes: %u", icon.c_str(), this->glyphs_.size());
+        return 0;
+    }
+    // Compressed glyphs are kept as received and decoded on draw through glyph_cache_,
+    // outlines are rasterized here once so the draw callback never does it
+    uint8_t fmt = header[4];
+    if ((fmt > GLYPH_FMT_OUTLINE) || (size > 0xFFFF)) {
+        ESP_LOGW(TAG, "add_glyph: icon: %s, unsupported format: %u, size: %u", icon.c_str(), fmt, size);
+        return 0;
+    }
+    ESP_LOGD(TAG, "add_glyph: icon: %s, format: %u, size: %u", icon.c_str(), fmt, size);
+    uint32_t stored = stored_size_(fmt, header[2], header[3], size);
+    // An empty glyph (blank box) takes no slab space, the slab may not even exist yet
+    if (stored > 0) {
+        uint8_t* buf = this->reserve_bitmap_(stored);
+        if (buf == 0) return 0;
+        if (fmt == GLYPH_FMT_OUTLINE) {
+            rasterize_outline_(header + ICON_HEADER, size, header[2], header[3], buf, stored);
+        } else {
+            memcpy(buf, header + ICON_HEADER, size);
+        }
+    }
+    uint32_t code = this->first_code_ + this->glyphs_.size();
+    this->glyphs_.push_back({
+        .bitmap = this->slab_used_, .size = (uint16_t)stored, .fmt = fmt, 
+        .ofs_x = header[0], .ofs_y = header[1], .box_w = header[2], .box_h = header[3]
+    });
+    this->slab_used_ += stored;
+    this->codes_[icon] = {.code = code, .hash = hash};
+    ESP_LOGD(TAG, "add_glyph: %u - %u - %u - %u", header[0], header[1], header[2], header[3]);
     return code;
 }
 
+static inline uint32_t read_le_(const uint8_t* data, int bytes) {
+    uint32_t result = 0;
+    for (int i = bytes - 1; i >= 0; i--) result = (result << 8) | data[i];
+    return result;
+}
+
+// Walks count glyph records: name length (1), name, hash (4), bitmap size (2), ICON_HEADER, bitmap.
+// Returns the number of bytes consumed, 0 when a record is truncated.
+static uint32_t walk_glyph_pack_(const uint8_t* data, uint32_t len, uint32_t count, 
+        std::function<void(const std::string&, uint32_t, const uint8_t*, uint32_t)> &&fn) {
+    uint32_t pos = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (pos + 1 > len) return 0;
+        uint32_t name_len = data[pos];
+        uint32_t header_end = pos + 1 + name_len + 4 + 2 + ICON_HEADER;
+        if (header_end > len) return 0;
+        const uint8_t* record = &data[pos + 1 + name_len];
+        uint32_t size = read_le_(record + 4, 2);
+        if (header_end + size > len) return 0;
+        fn(std::string((const char*)&data[pos + 1], name_len), read_le_(record, 4), record + 6, size);
+        pos = header_end + size;
+    }
+    return pos;
+}
+
+// Bitmaps are copied straight from the pack into the slab, which grows once for the whole pack
+uint32_t MdiFont::add_glyphs(const uint8_t* data, uint32_t len, uint32_t count) {
+    uint32_t total = 0;
+    if (walk_glyph_pack_(data, len, count, [&total](const std::string&, uint32_t, const uint8_t* header, uint32_t size) {
+        total += stored_size_(header[4], header[2], header[3], size);
+    }) == 0 && count > 0) {
+        ESP_LOGW(TAG, "MdiFont::add_glyphs: truncated pack: %u bytes, %u glyphs", len, count);
+        return 0;
+    }
+    if ((total > 0) && (this->reserve_bitmap_(total) == 0)) return 0;
+    uint32_t added = 0;
+    walk_glyph_pack_(data, len, count, [this, &added](const std::string &icon, uint32_t hash, const uint8_t* header, uint32_t size) {
+        if (this->find_glyph(icon, hash) != 0) return;
+        if (this->add_glyph_(icon, hash, header, size) != 0) added++;
+    });
+    return added;
+}
+
 void MdiFont::destroy() {
-    for (auto entry : this->glyphs_) {
-        mem_free_(entry.second);
-    }
+    glyph_cache_.drop(this);
+    if (this->slab_ != 0) {
+        mem_free_(this->slab_);
+        this->slab_ = 0;
+    }
+    this->slab_size_ = 0;
+    this->slab_used_ = 0;
+    // Codes of the previous set are not handed out again, back to the start once past half the range
+    this->first_code_ += this->glyphs_.size();
+    if (this->first_code_ > (ICON_FONT_CODE_START + ICON_FONT_CODE_END) / 2) this->first_code_ = ICON_FONT_CODE_START;
     this->glyphs_.clear();
     this->codes_.clear();
 }
@@ -239,6 +856,7 @@ void MdiFont::destroy() {
 
 MdiFont::MdiFont(int size) {
     this->size_ = size;
+    this->first_code_ = ICON_FONT_CODE_START;
     this->lv_font_.dsc = this;
     this->lv_font_.line_height = size + 1;
     this->lv_font_.base_line = 0;
@@ -249,28 +867,293 @@ MdiFont::MdiFont(int size) {
     this->lv_font_.underline_thickness = 1;
 }
 
+static bool _text_get_glyph_dsc_cb(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t unicode_letter, uint32_t next) {
+    return ((TextFont*) font->dsc)->create_glyph_dsc(unicode_letter, dsc);
+}
+
+static const uint8_t *_text_get_glyph_bitmap(const lv_font_t *font, uint32_t unicode_letter) {
+    return ((TextFont*) font->dsc)->get_glyph_data(unicode_letter);
+}
+
+TextFont::TextFont(int index, const lv_font_t* base) {
+    this->index_ = index;
+    this->base_ = base;
+    this->lv_font_.dsc = this;
+    this->lv_font_.line_height = base->line_height;
+    this->lv_font_.base_line = base->base_line;
+    this->lv_font_.get_glyph_dsc = _text_get_glyph_dsc_cb;
+    this->lv_font_.get_glyph_bitmap = _text_get_glyph_bitmap;
+    this->lv_font_.subpx = LV_FONT_SUBPX_NONE;
+    this->lv_font_.underline_position = base->underline_position;
+    this->lv_font_.underline_thickness = base->underline_thickness;
+    // The base font stays untouched, its callbacks find their data through dsc
+    this->primary_ = *base;
+    this->primary_.fallback = &this->lv_font_;
+}
+
+bool TextFont::create_glyph_dsc(uint32_t unicode_letter, lv_font_glyph_dsc_t *dsc) {
+    auto search = this->glyphs_.find(unicode_letter);
+    if (search == this->glyphs_.end()) {
+        // Control characters never have a glyph, everything else is asked for once
+        if ((unicode_letter >= 0x20) && this->requested_.insert(unicode_letter).second) {
+            this->missing_.push_back(unicode_letter);
+        }
+        return false;
+    }
+    const auto &glyph = search->second;
+    dsc->adv_w = glyph.adv_w;
+    dsc->ofs_x = glyph.ofs_x;
+    dsc->ofs_y = glyph.ofs_y;
+    dsc->box_w = glyph.box_w;
+    dsc->box_h = glyph.box_h;
+    dsc->is_placeholder = 0;
+    dsc->bpp = glyph.bpp;
+    return true;
+}
+
+const uint8_t* TextFont::get_glyph_data(uint32_t unicode_letter) {
+    auto search = this->glyphs_.find(unicode_letter);
+    if (search == this->glyphs_.end()) return 0;
+    search->second.used = ++this->clock_;
+    return search->second.bitmap;
+}
+
+// Least recently drawn glyphs go first, they are asked for again when drawn next time
+bool TextFont::evict_(uint32_t size) {
+    if (size > LVD_TEXT_GLYPH_BYTES) return false;
+    while (this->bytes_ + size > LVD_TEXT_GLYPH_BYTES) {
+        auto oldest = this->glyphs_.end();
+        for (auto it = this->glyphs_.begin(); it != this->glyphs_.end(); it++) {
+            if ((oldest == this->glyphs_.end()) || (it->second.used < oldest->second.used)) oldest = it;
+        }
+        if (oldest == this->glyphs_.end()) return false;
+        this->bytes_ -= ((uint32_t)oldest->second.box_w * oldest->second.box_h * oldest->second.bpp + 7) / 8;
+        mem_free_(oldest->second.bitmap);
+        this->requested_.erase(oldest->first);
+        this->glyphs_.erase(oldest);
+    }
+    return true;
+}
+
+// Records: code (4), adv_w, ofs_x, ofs_y, box_w, box_h, bpp, followed by the raw bitmap
+uint32_t TextFont::add_glyphs(const uint8_t* data, uint32_t len, uint32_t count) {
+    uint32_t pos = 0;
+    uint32_t added = 0;
+    for (uint32_t i = 0; (i < count) && (pos + 10 <= len); i++) {
+        const uint8_t* record = &data[pos];
+        uint32_t code = read_le_(record, 4);
+        uint8_t bpp = record[9];
+        uint32_t size = ((uint32_t)record[7] * record[8] * bpp + 7) / 8;
+        if ((pos + 10 + size > len) || ((bpp != 1) && (bpp != 2) && (bpp != 4) && (bpp != 8))) {
+            ESP_LOGW(TAG, "TextFont::add_glyphs: invalid record: %u, bpp: %u", code, bpp);
+            break;
+        }
+        pos += 10 + size;
+        if (this->glyphs_.count(code) != 0) continue;
+        if (!this->evict_(size)) continue;
+        uint8_t* bitmap = size > 0? mem_alloc_(size): 0;
+        if ((size > 0) && (bitmap == 0)) continue;
+        if (size > 0) memcpy(bitmap, record + 10, size);
+        this->glyphs_[code] = {
+            .bitmap = bitmap, .used = this->clock_, .adv_w = record[4], 
+            .ofs_x = (int8_t)record[5], .ofs_y = (int8_t)record[6], .box_w = record[7], .box_h = record[8], .bpp = bpp
+        };
+        this->requested_.insert(code);
+        this->bytes_ += size;
+        added++;
+    }
+    return added;
+}
+
+bool TextFont::take_missing(std::vector<uint32_t> &codes) {
+    if (this->missing_.empty()) return false;
+    size_t count = std::min(this->missing_.size(), (size_t)LVD_TEXT_GLYPH_REQUEST);
+    codes.assign(this->missing_.begin(), this->missing_.begin() + count);
+    this->missing_.erase(this->missing_.begin(), this->missing_.begin() + count);
+    return true;
+}
+
+// Codepoints the integration had no glyph for are asked for again when drawn
+void TextFont::retry() {
+    this->requested_.clear();
+    for (auto &it : this->glyphs_) this->requested_.insert(it.first);
+}
+
+void TextFont::clear() {
+    for (auto &it : this->glyphs_) {
+        if (it.second.bitmap != 0) mem_free_(it.second.bitmap);
+    }
+    this->glyphs_.clear();
+    this->requested_.clear();
+    this->missing_.clear();
+    this->bytes_ = 0;
+}
+
+// Back buffer for the next frame, kept across frames of the same size class
 uint8_t* WithDataBuffer::create_data_(uint32_t size) {
-    if (this->data_ != 0) {
-        mem_free_(this->data_);
+    if ((this->back_ != 0) && (BufferPool::size_class(this->back_size_) == BufferPool::size_class(size))) {
+        this->back_size_ = size;
+        return this->back_;
     }
-    this->data_ = mem_alloc_(size);
-    this->data_size_ = size;
-    return this->data_;
+    if (this->back_ != 0) {
+        image_buffers_.release(this->back_, this->back_size_);
+    }
+    this->back_ = image_buffers_.acquire(size);
+    this->back_size_ = this->back_ != 0? size: 0;
+    return this->back_;
+}
+
+// Completed back buffer becomes the shown frame, the previous one takes the next
+void WithDataBuffer::swap_data_() {
+    std::swap(this->data_, this->back_);
+    std::swap(this->data_size_, this->back_size_);
 }
+
 bool WithDataBuffer::set_data_(int32_t* data, int size, int offset, int total_size) {
     if (offset == 0) {
         this->create_data_(total_size * 4);
     }
-    memcpy(&this->data_[offset * 4], data, size * 4);
+    if ((this->back_ == 0) || ((uint32_t)(offset + size) * 4 > this->back_size_)) {
+        ESP_LOGW(TAG, "WithDataBuffer::set_data_: invalid chunk: %d / %d", offset, total_size);
+        return false;
+    }
+    memcpy(&this->back_[offset * 4], data, size * 4);
     if ((offset + size) == total_size) {
         return true;
     }
     return false;
 }
+static inline int b64_value_(char c) {
+    if ((c >= 'A') && (c <= 'Z')) return c - 'A';
+    if ((c >= 'a') && (c <= 'z')) return c - 'a' + 26;
+    if ((c >= '0') && (c <= '9')) return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// Decodes straight into the destination, returns the number of bytes written or -1
+static int b64_decode_into_(const std::string &src, uint8_t* to, uint32_t to_len) {
+    uint32_t written = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : src) {
+        if (c == '=') break;
+        int value = b64_value_(c);
+        if (value < 0) return -1;
+        acc = (acc << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (written >= to_len) return -1;
+            to[written++] = (acc >> bits) & 0xFF;
+        }
+    }
+    return written;
+}
+
+// Base64 chunk at a byte offset of the final buffer
+bool WithDataBuffer::set_data_b64_(const std::string &data, int offset, int total_size) {
+    if (offset == 0) {
+        this->create_data_(total_size);
+    }
+    if ((this->back_ == 0) || (offset < 0) || ((uint32_t)total_size != this->back_size_) || (offset > total_size)) {
+        ESP_LOGW(TAG, "WithDataBuffer::set_data_b64_: invalid chunk: %d / %d", offset, total_size);
+        return false;
+    }
+    int written = b64_decode_into_(data, &this->back_[offset], this->back_size_ - offset);
+    if (written < 0) {
+        ESP_LOGW(TAG, "WithDataBuffer::set_data_b64_: invalid data at %d", offset);
+        return false;
+    }
+    return (offset + written) == total_size;
+}
+
+// Base64 chunk of the compressed source at a byte offset
+bool WithDataBuffer::set_src_b64_(const std::string &data, int offset, int total_size) {
+    if (offset == 0) {
+        if (this->src_ != 0) mem_free_(this->src_);
+        this->src_ = mem_alloc_(total_size);
+        this->src_size_ = total_size;
+    }
+    if ((this->src_ == 0) || (offset < 0) || ((uint32_t)total_size != this->src_size_) || (offset > total_size)) {
+        ESP_LOGW(TAG, "WithDataBuffer::set_src_b64_: invalid chunk: %d / %d", offset, total_size);
+        return false;
+    }
+    int written = b64_decode_into_(data, &this->src_[offset], this->src_size_ - offset);
+    if (written < 0) {
+        ESP_LOGW(TAG, "WithDataBuffer::set_src_b64_: invalid data at %d", offset);
+        return false;
+    }
+    return (offset + written) == total_size;
+}
+
+#ifdef USE_LVD_JPEG
+typedef struct {
+    uint8_t* data;
+    uint32_t width;
+    uint32_t height;
+} JpegTarget;
+
+// Decoded MCU blocks are copied row by row into the image buffer, clipped to the image
+static int jpeg_draw_(JPEGDRAW* draw) {
+    auto* target = (JpegTarget*) draw->pUser;
+    if ((draw->x >= target->width) || (draw->y >= target->height)) return 1;
+    uint32_t w = std::min((uint32_t)draw->iWidth, target->width - draw->x);
+    uint32_t h = std::min((uint32_t)draw->iHeight, target->height - draw->y);
+    for (uint32_t row = 0; row < h; row++) {
+        memcpy(&target->data[((draw->y + row) * target->width + draw->x) * 2], &draw->pPixels[row * draw->iWidth], w * 2);
+    }
+    return 1;
+}
+#endif
+
+// Decodes the complete source into an RGB565 back buffer and frees the source
+bool WithDataBuffer::decode_jpeg_(bool little_endian, lv_img_header_t* header) {
+    bool result = false;
+    #ifdef USE_LVD_JPEG
+    auto* jpeg = new (std::nothrow) JPEGDEC();
+    if ((jpeg != 0) && jpeg->openRAM(this->src_, this->src_size_, jpeg_draw_)) {
+        JpegTarget target = {.data = 0, .width = (uint32_t)jpeg->getWidth(), .height = (uint32_t)jpeg->getHeight()};
+        target.data = this->create_data_(target.width * target.height * 2);
+        if (target.data != 0) {
+            jpeg->setUserPointer(&target);
+            jpeg->setPixelType(little_endian? RGB565_LITTLE_ENDIAN: RGB565_BIG_ENDIAN);
+            result = jpeg->decode(0, 0, 0) == 1;
+            header->w = target.width;
+            header->h = target.height;
+            header->cf = LV_IMG_CF_TRUE_COLOR;
+        }
+        jpeg->close();
+    }
+    if (!result) ESP_LOGW(TAG, "WithDataBuffer::decode_jpeg_: failed: %u bytes", this->src_size_);
+    delete jpeg;
+    #else
+    ESP_LOGW(TAG, "WithDataBuffer::decode_jpeg_: JPEG support is not enabled");
+    #endif
+    if (this->src_ != 0) {
+        mem_free_(this->src_);
+        this->src_ = 0;
+        this->src_size_ = 0;
+    }
+    return result;
+}
+
 void WithDataBuffer::destroy_() {
     if (this->data_ != 0) {
-        mem_free_(this->data_);
+        image_buffers_.release(this->data_, this->data_size_);
         this->data_ = 0;
+        this->data_size_ = 0;
+    }
+    if (this->back_ != 0) {
+        image_buffers_.release(this->back_, this->back_size_);
+        this->back_ = 0;
+        this->back_size_ = 0;
+    }
+    if (this->src_ != 0) {
+        mem_free_(this->src_);
+        this->src_ = 0;
+        this->src_size_ = 0;
     }
 }
 
@@ -496,39 +1379,121 @@ MdiFont* MdiFontCapable::get_font(int size) {
     if (auto search = this->fonts_.find(size); search != this->fonts_.end()) 
         return search->second;
     MdiFont* font = new MdiFont(size);
+    if (auto search = this->static_.find(size); search != this->static_.end())
+        font->set_static(search->second);
     this->fonts_[size] = font;
     return font;
 }
 
-void MdiFontCapable::set_icon(lv_obj_t* obj, JsonObject icon_data, bool hide_default) {
+// Kept apart from fonts_, so static glyphs outlive clear()
+void MdiFontCapable::add_static(int size, const StaticGlyph* glyphs, uint32_t count, const uint8_t* bitmaps) {
+    StaticGlyphs value = {.glyphs = glyphs, .count = count, .bitmaps = bitmaps};
+    this->static_[size] = value;
+    if (auto search = this->fonts_.find(size); search != this->fonts_.end())
+        search->second->set_static(value);
+}
+
+// The integration rebuilds its record of sent glyphs from these after a reconnect or a restart
+std::string MdiFontCapable::get_records() {
+    std::string result;
+    for (auto &it : this->fonts_) it.second->append_records(result);
+    return result;
+}
+
+// "size:name,name;size:name", the integration sends these icons by name only
+std::string MdiFontCapable::get_static_names() {
+    std::string result;
+    for (auto &it : this->static_) {
+        if (!result.empty()) result += ";";
+        result += std::to_string(it.first) + ":";
+        for (uint32_t i = 0; i < it.second.count; i++) {
+            if (i > 0) result += ",";
+            result += it.second.glyphs[i].name;
+        }
+    }
+    return result;
+}
+
+bool MdiFontCapable::set_icon(lv_obj_t* obj, JsonObject icon_data, bool hide_default) {
     int size = icon_data["size"];
     bool default_icon = icon_data["def"];
     auto* font = this->get_font(size);
-    auto code = font->add_glyph(icon_data["name"], icon_data["data"]);
+    uint32_t hash = icon_data["h"];
+    uint32_t code;
+    if (icon_data.containsKey("data")) {
+        code = font->add_glyph(icon_data["name"], hash, icon_data["data"]);
+    } else {
+        // Name only: the integration assumes the glyph is already here
+        code = font->find_glyph(icon_data["name"], hash);
+        if (code == 0) {
+            ESP_LOGD(TAG, "MdiFontCapable::set_icon: miss: %s, %d", icon_data["name"].as<const char*>(), size);
+            this->misses_++;
+        }
+    }
     lv_obj_set_style_text_font(obj, font->get_lv_font(), 0);
-    char txt[2] = {(char)code, 0};
+    char txt[4] = {0};
+    if (code != 0) {
+        // 3 byte UTF-8 sequence of the private use code point
+        txt[0] = (char)(0xE0 | (code >> 12));
+        txt[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        txt[2] = (char)(0x80 | (code & 0x3F));
+    }
     lv_label_set_text(obj, (char *)&txt);
     if (default_icon && hide_default) {
         lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
     } else {
         lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
     }
+    return code != 0;
 }
 
+// Pack header: font size (2), glyph count (2), followed by the glyph records
+uint32_t MdiFontCapable::add_glyph_pack(const uint8_t* data, uint32_t len) {
+    if (len < 4) return 0;
+    int size = read_le_(data, 2);
+    uint32_t count = read_le_(data + 2, 2);
+    return this->get_font(size)->add_glyphs(data + 4, len - 4, count);
+}
+
+uint32_t MdiFontCapable::digest(uint32_t* count) {
+    uint32_t result = 0;
+    *count = 0;
+    for (auto it : this->fonts_) {
+        result ^= it.second->digest(count);
+    }
+    return result;
+}
+
+// Fonts stay allocated, labels on the top bar and on pages not rebuilt yet still point at their lv_font_t
 void MdiFontCapable::clear() {
     for (auto it : this->fonts_) {
         it.second->destroy();
-        free(it.second);
     }
-    this->fonts_.clear();
+    lv_obj_invalidate(lv_layer_top());
+    lv_obj_invalidate(lv_scr_act());
+}
+
+// "#rrggbb" from JSON payloads, pre-parsed 0xRRGGBB integer from binary ones
+static bool color_from_variant_(JsonVariant value, lv_color_t* color) {
+    if (value.is<int>()) {
+        *color = lv_color_hex(value.as<uint32_t>());
+        return true;
+    }
+    const char* str = value.as<const char*>();
+    if ((str != nullptr) && (str[0] == '#') && (strlen(str) == 7)) {
+        *color = lv_color_hex((uint32_t)strtoul(str + 1, nullptr, 16));
+        return true;
+    }
+    return false;
 }
 
-lv_color_t DashboardItem::parse_color(std::string color, lv_color_t def_color) {
+lv_color_t DashboardItem::parse_color(JsonVariant color, lv_color_t def_color) {
     if (color == "on") {
         return theme_.btn_on_color;
     }
-    if (color.size() == 7) {
-        return lv_color_hex((uint32_t)std::stol(color.substr(1), nullptr, 16));
+    lv_color_t result;
+    if (color_from_variant_(color, &result)) {
+        return result;
     }
     return def_color;
 }
@@ -539,9 +1504,10 @@ void DashboardItem::set_bg_color(lv_obj_t* obj, JsonObject data) {
 
 void DashboardItem::set_bg_color(lv_obj_t* obj, JsonObject data, bool def_color) {
     std::string mode = data["ctype"];
-    std::string color = data["col"];
+    JsonVariant color = data["col"];
+    lv_color_t value;
     if (def_color) lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
-    if (color == "") {
+    if (color.isNull() || (color == "")) {
         if (def_color) lv_obj_set_style_bg_color(obj, theme_.btn_bg_color, 0);
         return;
     }
@@ -558,9 +1524,9 @@ void DashboardItem::set_bg_color(lv_obj_t* obj, JsonObject data, bool def_color)
         lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, 0);
         return;
     }
-    if (color.size() == 7) {
+    if (color_from_variant_(color, &value)) {
         lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
-        lv_obj_set_style_bg_color(obj, lv_color_hex((uint32_t)std::stol(color.substr(1), nullptr, 16)), 0);
+        lv_obj_set_style_bg_color(obj, value, 0);
         return;
     }
     if (def_color) lv_obj_set_style_bg_color(obj, theme_.btn_bg_color, 0);
@@ -568,8 +1534,9 @@ void DashboardItem::set_bg_color(lv_obj_t* obj, JsonObject data, bool def_color)
 
 void DashboardItem::set_text_color(lv_obj_t* obj, JsonObject data) {
     std::string mode = data["ctype"];
-    std::string color = data["col"];
-    if (color == "") {
+    JsonVariant color = data["col"];
+    lv_color_t value;
+    if (color.isNull() || (color == "")) {
         lv_obj_set_style_text_color(obj, theme_.text_color, 0);
         return;
     }
@@ -578,17 +1545,14 @@ void DashboardItem::set_text_color(lv_obj_t* obj, JsonObject data) {
             lv_obj_set_style_text_color(obj, theme_.btn_on_color, 0);
             return;
         }
-        if (color.size() == 7) {
-            lv_obj_set_style_text_color(obj, lv_color_hex((uint32_t)std::stol(color.substr(1), nullptr, 16)), 0);
+        if (color_from_variant_(color, &value)) {
+            lv_obj_set_style_text_color(obj, value, 0);
             return;
         }
         lv_obj_set_style_text_color(obj, theme_.text_color, 0);
         return;
     }
-    if (color.size() > 0) {
-        lv_obj_set_style_text_color(obj, theme_.bg_color, 0); // BG set - dark text
-        return;
-    }
+    lv_obj_set_style_text_color(obj, theme_.bg_color, 0); // BG set - dark text
 }
 
 void DashboardItem::set_font(lv_obj_t* obj, JsonObject data) {
@@ -607,31 +1571,122 @@ void DashboardItem::set_font(lv_obj_t* obj, JsonObject data) {
 
 
 
-void LayoutItem::set_value(JsonObject data) {
-    lv_obj_clean(this->root_);
-    JsonArray cols_ = data["cols"];
-    for (int i = 0; i < cols_.size(); i++) {
-        int fr = cols_[i];
-        this->col_dsc_[i] = LV_GRID_FR(fr);
+static std::string variant_str_(JsonVariant value) {
+    std::string result;
+    serializeJson(value, result);
+    return result;
+}
+
+// The last slot is the terminator. LVGL keeps a pointer to the array, so a change
+// of the track count (which may move it) always reports a change.
+bool LayoutItem::set_grid_dsc(std::vector<lv_coord_t> &dsc, JsonArray values) {
+    size_t count = values.size();
+    bool changed = dsc.size() != count + 1;
+    if (changed) {
+        dsc.assign(count + 1, LV_GRID_TEMPLATE_LAST);
     }
-    this->col_dsc_[cols_.size()] = LV_GRID_TEMPLATE_LAST;
-    lv_obj_set_style_grid_column_dsc_array(this->root_, this->col_dsc_, 0);
+    for (size_t i = 0; i < count; i++) {
+        lv_coord_t value = LV_GRID_FR(values[i].as<int>());
+        if (dsc[i] != value) {
+            dsc[i] = value;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+lv_obj_t* LayoutItem::create_shape(std::string shape) {
+    if ((shape != "rr") && (shape != "r") && (shape != "cl") && (shape != "sq") && (shape != "rs")) return 0;
+    lv_obj_t* shape_ = lv_obj_create(this->root_);
+    lv_obj_remove_style_all(shape_);
+    if ((shape == "rr") || (shape == "rs")) {
+        // Rounded rectangle / square
+        lv_obj_set_style_radius(shape_, theme_.layout_gap, 0);
+    }
+    return shape_;
+}
+
+void LayoutItem::update_cell(LayoutCell* cell, JsonObject item, int cols, int rows) {
+    uint16_t r = item["r"];
+    bool geometry = (cell->cols != cols) || (cell->rows != rows) || (cell->radius != r);
+    cell->cols = cols;
+    cell->rows = rows;
+    cell->radius = r;
+    if (geometry) {
+        std::string shape = cell->shape;
+        if (cell->shape_obj == 0) {
+            lv_obj_set_grid_cell(cell->label, LV_GRID_ALIGN_CENTER, cell->col, cols, LV_GRID_ALIGN_CENTER, cell->row, rows);
+        } else if ((shape == "rr") || (shape == "r")) {
+            // Rectangles fill the cell
+            lv_obj_set_grid_cell(cell->shape_obj, LV_GRID_ALIGN_STRETCH, cell->col, cols, LV_GRID_ALIGN_STRETCH, cell->row, rows);
+        } else {
+            // Circles and squares are sized by radius
+            lv_obj_set_grid_cell(cell->shape_obj, LV_GRID_ALIGN_CENTER, cell->col, cols, LV_GRID_ALIGN_CENTER, cell->row, rows);
+            if (shape == "cl") lv_obj_set_style_radius(cell->shape_obj, r, 0);
+            lv_obj_set_size(cell->shape_obj, r * 2, r * 2);
+        }
+    }
+
+    bool icon = item.containsKey("icon");
+    std::string content;
+    if (icon) {
+        JsonObject icon_data = item["icon"];
+        content = variant_str_(icon_data["name"]) + ":" + variant_str_(icon_data["size"]) + ":" + variant_str_(icon_data["h"]);
+    } else {
+        content = item["label"].as<std::string>();
+    }
+    std::string style = variant_str_(item["ctype"]) + "|" + variant_str_(item["col"]) + "|" + variant_str_(item["font"]);
+    if ((cell->icon != icon) || (cell->style != style)) {
+        // Font depends on both content kind and style
+        lv_obj_remove_local_style_prop(cell->label, LV_STYLE_TEXT_FONT, 0);
+        cell->content = "";
+    }
+    if (cell->content != content) {
+        if (icon) {
+            // Missing glyph: retry on the next payload
+            if (!icons_->set_icon(cell->label, item["icon"])) content = "";
+        } else {
+            this->set_font(cell->label, item);
+            lv_label_set_text(cell->label, content.c_str());
+        }
+    }
+    if (cell->style != style) {
+        if (cell->shape_obj != 0) {
+            lv_obj_set_style_bg_opa(cell->shape_obj, LV_OPA_TRANSP, 0);
+            this->set_bg_color(cell->shape_obj, item, false);
+        }
+        this->set_text_color(cell->label, item);
+    }
+    cell->icon = icon;
+    cell->content = content;
+    cell->style = style;
+}
 
+void LayoutItem::set_value(JsonObject data) {
+    JsonArray cols_ = data["cols"];
     JsonArray rows_ = data["rows"];
-    for (int i = 0; i < rows_.size(); i++) {
-        int fr = rows_[i];
-        this->row_dsc_[i] = LV_GRID_FR(fr);
+    int grid_cols = cols_.size();
+    int grid_rows = rows_.size();
+    if ((grid_cols < 1) || (grid_rows < 1) || (grid_cols > LVD_MAX_GRID) || (grid_rows > LVD_MAX_GRID)) {
+        ESP_LOGW(TAG, "LayoutItem::set_value: layout rejected: %d x %d", grid_cols, grid_rows);
+        return;
+    }
+    if (this->set_grid_dsc(this->col_dsc_, cols_) || !this->grid_set_)
+        lv_obj_set_style_grid_column_dsc_array(this->root_, this->col_dsc_.data(), 0);
+    if (this->set_grid_dsc(this->row_dsc_, rows_) || !this->grid_set_)
+        lv_obj_set_style_grid_row_dsc_array(this->root_, this->row_dsc_.data(), 0);
+    if (!this->grid_set_) {
+        lv_obj_set_style_pad_row(this->root_, theme_.layout_gap, 0);
+        lv_obj_set_style_pad_column(this->root_, theme_.layout_gap, 0);
+        lv_obj_set_layout(this->root_, LV_LAYOUT_GRID);
+        this->grid_set_ = true;
     }
-    this->row_dsc_[rows_.size()] = LV_GRID_TEMPLATE_LAST;
-    lv_obj_set_style_grid_row_dsc_array(this->root_, this->row_dsc_, 0);
-    lv_obj_set_style_pad_row(this->root_, theme_.layout_gap, 0);
-    lv_obj_set_style_pad_column(this->root_, theme_.layout_gap, 0);
-    lv_obj_set_layout(this->root_, LV_LAYOUT_GRID);
     JsonArray items = data["items"];
+    std::vector<LayoutCell> cells;
     int col = 0;
     int row = 0;
     for (int i = 0; i< items.size(); i++) {
-        if (col >= cols_.size()) {
+        if (col >= grid_cols) {
             row++;
             col = 0;
         }
@@ -643,6 +1698,10 @@ void LayoutItem::set_value(JsonObject data) {
         int rows = 1;
         if (item.containsKey("w")) cols = item["w"];
         if (item.containsKey("h")) rows = item["h"];
+        if ((col < 0) || (row < 0) || (col + cols > grid_cols) || (row + rows > grid_rows)) {
+            col += cols;
+            continue;
+        }
 
         if (item.containsKey("_h")) {
             bool hidden = item["_h"];
@@ -651,71 +1710,44 @@ void LayoutItem::set_value(JsonObject data) {
                 continue;
             }
         }
-        lv_obj_t* parent = this->root_;
-        lv_obj_t* shape_ = 0;
-        if (item.containsKey("shp")) {
-            std::string shape = item["shp"];
-            if (shape == "rr") {
-                // Rounded rectangle
-                shape_ = lv_obj_create(this->root_);
-                lv_obj_remove_style_all(shape_);
-                lv_obj_set_grid_cell(shape_, LV_GRID_ALIGN_STRETCH, col, cols, LV_GRID_ALIGN_STRETCH, row, rows);
-                lv_obj_set_style_radius(shape_, theme_.layout_gap, 0);
-            }
-            if (shape == "r") {
-                // Rectangle
-                shape_ = lv_obj_create(this->root_);
-                lv_obj_remove_style_all(shape_);
-                lv_obj_set_grid_cell(shape_, LV_GRID_ALIGN_STRETCH, col, cols, LV_GRID_ALIGN_STRETCH, row, rows);
-            }
-            if (shape == "cl") {
-                // Circle
-                shape_ = lv_obj_create(this->root_);
-                lv_obj_remove_style_all(shape_);
-                lv_obj_set_grid_cell(shape_, LV_GRID_ALIGN_CENTER, col, cols, LV_GRID_ALIGN_CENTER, row, rows);
-                uint16_t r = item["r"];
-                lv_obj_set_style_radius(shape_, r, 0);
-                lv_obj_set_size(shape_, r * 2, r * 2);
-            }
-            if (shape == "sq") {
-                // Square
-                shape_ = lv_obj_create(this->root_);
-                lv_obj_remove_style_all(shape_);
-                lv_obj_set_grid_cell(shape_, LV_GRID_ALIGN_CENTER, col, cols, LV_GRID_ALIGN_CENTER, row, rows);
-                uint16_t r = item["r"];
-                lv_obj_set_size(shape_, r * 2, r * 2);
-            }
-            if (shape == "rs") {
-                // Rounded square
-                shape_ = lv_obj_create(this->root_);
-                lv_obj_remove_style_all(shape_);
-                lv_obj_set_grid_cell(shape_, LV_GRID_ALIGN_CENTER, col, cols, LV_GRID_ALIGN_CENTER, row, rows);
-                lv_obj_set_style_radius(shape_, theme_.layout_gap, 0);
-                uint16_t r = item["r"];
-                lv_obj_set_size(shape_, r * 2, r * 2);
-            }
-            if (shape_ != 0) {
-                parent = shape_;
-                lv_obj_set_style_bg_opa(shape_, LV_OPA_TRANSP, 0);
-                this->set_bg_color(shape_, item, false);
+        std::string shape = item.containsKey("shp")? item["shp"].as<std::string>(): "";
+        // Reuse existing objects with the same position and shape
+        LayoutCell cell = {.col = col, .row = row, .shape = shape, .cols = 0, .rows = 0, .radius = 0, .icon = false, .shape_obj = 0, .label = 0};
+        for (auto it = this->cells_.begin(); it != this->cells_.end(); it++) {
+            if ((it->col == col) && (it->row == row) && (it->shape == shape)) {
+                cell = *it;
+                this->cells_.erase(it);
+                break;
             }
         }
-        lv_obj_t* obj = lv_label_create(parent);
-        if (shape_ != 0) {
-            lv_obj_center(obj);
-        } else {
-            lv_obj_set_grid_cell(obj, LV_GRID_ALIGN_CENTER, col, cols, LV_GRID_ALIGN_CENTER, row, rows);
+        if (cell.label == 0) {
+            cell.shape_obj = this->create_shape(shape);
+            cell.label = lv_label_create(cell.shape_obj != 0? cell.shape_obj: this->root_);
+            if (cell.shape_obj != 0) {
+                lv_obj_set_style_bg_opa(cell.shape_obj, LV_OPA_TRANSP, 0);
+                lv_obj_center(cell.label);
+            }
         }
-        if (item.containsKey("icon")) {
-            icons_->set_icon(obj, item["icon"]);
-        } else {
-            this->set_font(obj, item);
-            lv_label_set_text(obj, item["label"]);
+        // Keep drawing order of the payload
+        lv_obj_t* obj = cell.shape_obj != 0? cell.shape_obj: cell.label;
+        if (lv_obj_get_index(obj) != cells.size()) {
+            lv_obj_move_to_index(obj, cells.size());
         }
-        this->set_text_color(obj, item);
+        this->update_cell(&cell, item, cols, rows);
+        cells.push_back(cell);
         col += cols;
     }
-    this->set_bg_color(this->root_, data);
+    // Cells without a match in the new payload
+    for (auto &cell : this->cells_) {
+        lv_obj_del(cell.shape_obj != 0? cell.shape_obj: cell.label);
+    }
+    this->cells_ = cells;
+
+    std::string style = variant_str_(data["ctype"]) + "|" + variant_str_(data["col"]);
+    if (style != this->style_) {
+        this->set_bg_color(this->root_, data);
+        this->style_ = style;
+    }
 }
 
 void ButtonItem::set_value(JsonObject data) {
@@ -741,18 +1773,169 @@ void SensorItem::set_value(JsonObject data) {
     }
 }
 
-void ImageItem::set_data(int32_t* data, int size, int offset, int total_size) {
-    if (this->set_data_(data, size, offset, total_size)) {
-        this->show();
+void ImageItem::set_data(int32_t* data, int size, int offset, int total_size) {
+    if (this->set_data_(data, size, offset, total_size)) {
+        this->show();
+    }
+}
+
+void ImageItem::set_data_b64(const std::string &data, int offset, int total_size) {
+    if (this->set_data_b64_(data, offset, total_size)) {
+        this->show();
+    }
+}
+
+void ImageItem::set_data_jpeg(const std::string &data, int offset, int total_size, bool little_endian) {
+    if (this->set_src_b64_(data, offset, total_size) && this->decode_jpeg_(little_endian, &this->header_)) {
+        this->show();
+    }
+}
+
+// Current frame is shown and RGB565, so it can be patched in place.
+// Frames sent as int[] end with up to 3 bytes of padding.
+bool ImageItem::has_frame_() {
+    return (this->data_ != 0) && (this->image_.data == this->data_) && (this->image_.header.cf == LV_IMG_CF_TRUE_COLOR) &&
+        (this->data_size_ >= this->image_.header.w * this->image_.header.h * 2);
+}
+
+uint32_t ImageItem::get_frame_hash() {
+    if (!this->has_frame_()) {
+        if (this->data_ != 0) {
+            ESP_LOGD(TAG, "ImageItem::get_frame_hash: not patchable: cf: %u, %u x %u, %u bytes", 
+                this->image_.header.cf, this->image_.header.w, this->image_.header.h, this->data_size_);
+        }
+        return 0;
+    }
+    return this->frame_hash_;
+}
+
+// Hash of the shown frame, refreshed whenever the frame is replaced or patched
+void ImageItem::update_frame_hash_() {
+    this->frame_hash_ = this->has_frame_()? fnv1a_(this->data_, this->image_.header.w * this->image_.header.h * 2): 0;
+}
+
+// lv_img draws from the top left of its content area, shifted by the image offset
+// and tiled over the object. Offset, zoomed or rotated images are redrawn whole.
+void ImageItem::invalidate_(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if ((lv_img_get_offset_x(this->lv_img_) != 0) || (lv_img_get_offset_y(this->lv_img_) != 0) ||
+        (lv_img_get_zoom(this->lv_img_) != LV_IMG_ZOOM_NONE) || (lv_img_get_angle(this->lv_img_) != 0)) {
+        lv_obj_invalidate(this->lv_img_);
+        return;
+    }
+    lv_area_t area;
+    lv_obj_get_content_coords(this->lv_img_, &area);
+    if ((lv_area_get_width(&area) > this->image_.header.w) || (lv_area_get_height(&area) > this->image_.header.h)) {
+        // Content area larger than the image: the rectangle repeats
+        lv_obj_invalidate(this->lv_img_);
+        return;
+    }
+    area.x1 += x;
+    area.y1 += y;
+    area.x2 = area.x1 + w - 1;
+    area.y2 = area.y1 + h - 1;
+    lv_obj_invalidate_area(this->lv_img_, &area);
+}
+
+// Solid fill, color in the byte order of the buffer
+void ImageItem::draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint16_t color) {
+    if (!this->has_frame_() || (x + w > this->image_.header.w) || (y + h > this->image_.header.h)) return;
+    for (uint32_t row = y; row < y + h; row++) {
+        uint16_t* pixel = (uint16_t*)&this->data_[(row * this->image_.header.w + x) * 2];
+        for (uint32_t col = 0; col < w; col++) *pixel++ = color;
+    }
+    this->invalidate_(x, y, w, h);
+}
+
+void ImageItem::draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h, const uint8_t* pixels) {
+    if (!this->has_frame_() || (x + w > this->image_.header.w) || (y + h > this->image_.header.h)) return;
+    for (uint32_t row = 0; row < h; row++) {
+        memcpy(&this->data_[((y + row) * this->image_.header.w + x) * 2], &pixels[row * w * 2], w * 2);
+    }
+    this->invalidate_(x, y, w, h);
+}
+
+// Changed rectangles of the shown frame, each: x, y, w, h (2 bytes), kind (1 byte),
+// then w * h pixels (kind 0) or a single fill color (kind 1) in the byte order of the buffer
+void ImageItem::set_data_rect(const std::string &data) {
+    if (!this->has_frame_()) {
+        ESP_LOGW(TAG, "ImageItem::set_data_rect: no frame to patch, requesting it");
+        this->request_data();
+        return;
+    }
+    uint32_t size = data.size() / 4 * 3 + 3;
+    uint8_t* blob = mem_alloc_(size);
+    if (blob == 0) return;
+    int len = b64_decode_into_(data, blob, size);
+    int pos = 0;
+    while ((len > 0) && (pos + 9 <= len)) {
+        uint32_t x = read_le_(&blob[pos], 2);
+        uint32_t y = read_le_(&blob[pos + 2], 2);
+        uint32_t w = read_le_(&blob[pos + 4], 2);
+        uint32_t h = read_le_(&blob[pos + 6], 2);
+        uint8_t kind = blob[pos + 8];
+        pos += 9;
+        uint32_t bytes = kind == 0? w * h * 2: 2;
+        if ((pos + bytes > (uint32_t)len) || (x + w > this->image_.header.w) || (y + h > this->image_.header.h)) {
+            ESP_LOGW(TAG, "ImageItem::set_data_rect: invalid rect %u, %u, %u x %u", x, y, w, h);
+            break;
+        }
+        if (kind == 0) {
+            this->draw(x, y, w, h, &blob[pos]);
+        } else {
+            uint16_t color;
+            memcpy(&color, &blob[pos], 2);
+            this->draw(x, y, w, h, color);
+        }
+        pos += bytes;
+    }
+    mem_free_(blob);
+    this->update_frame_hash_();
+}
+
+// "cf" of an image value: indexed with a palette, alpha only or RGB565 by default
+static lv_img_cf_t image_cf_(JsonVariant value) {
+    static const std::map<std::string, lv_img_cf_t> formats = {
+        {"i1", LV_IMG_CF_INDEXED_1BIT}, {"i2", LV_IMG_CF_INDEXED_2BIT},
+        {"i4", LV_IMG_CF_INDEXED_4BIT}, {"i8", LV_IMG_CF_INDEXED_8BIT},
+        {"a8", LV_IMG_CF_ALPHA_8BIT},
+    };
+    if (value.is<const char*>()) {
+        if (auto search = formats.find(value.as<std::string>()); search != formats.end()) return search->second;
+    }
+    return LV_IMG_CF_TRUE_COLOR;
+}
+
+// Alpha only images take the theme text color
+static void image_tint_(lv_obj_t* img, lv_img_cf_t cf) {
+    bool alpha = cf == LV_IMG_CF_ALPHA_8BIT;
+    lv_obj_set_style_img_recolor(img, theme_.text_color, 0);
+    lv_obj_set_style_img_recolor_opa(img, alpha? LV_OPA_COVER: LV_OPA_TRANSP, 0);
+}
+
+// Palette and pixel rows as LVGL expects them for the header format
+static bool image_complete_(const lv_img_header_t &header, uint32_t size) {
+    uint32_t expected = lv_img_buf_get_img_size(header.w, header.h, header.cf);
+    if (size < expected) {
+        ESP_LOGW(TAG, "image_complete_: %u x %u, cf: %u, %u of %u bytes", header.w, header.h, header.cf, size, expected);
+        return false;
     }
+    return true;
 }
 
+// Swaps the completed frame in, so chunks never stream into the frame on screen
 void ImageItem::show() {
     ESP_LOGD(TAG, "ImageItem::show");
+    if (!image_complete_(this->header_, this->back_size_)) return;
+    this->swap_data_();
+    this->image_.header = this->header_;
     this->image_.data_size = this->data_size_;
     this->image_.data = (unsigned char*)this->data_;
     // ESP_LOGD(TAG, "DashboardItem::set_value: image: %d, %d, %lu", this->image_.header.w, this->image_.header.h, this->data_size_);
+    image_tint_(this->lv_img_, this->image_.header.cf);
+    // The descriptor is reused for every frame
+    lv_img_cache_invalidate_src(&this->image_);
     lv_img_set_src(this->lv_img_, &this->image_);
+    this->update_frame_hash_();
 }
 
 bool ImageItem::show(bool visible) {
@@ -770,10 +1953,10 @@ void ImageItem::set_value(JsonObject data) {
     this->set_bg_color(this->root_, data);
     if (!image.isNull()) {
         ESP_LOGD(TAG, "ImageItem::set_value");
-        this->image_.header.always_zero = 0;
-        this->image_.header.w = image["width"];
-        this->image_.header.h = image["height"];
-        this->image_.header.cf = LV_IMG_CF_TRUE_COLOR;
+        this->header_.always_zero = 0;
+        this->header_.w = image["width"];
+        this->header_.h = image["height"];
+        this->header_.cf = image_cf_(image["cf"]);
         if (this->visible_) {
             this->data_pending_ = false;
             this->request_data();
@@ -811,11 +1994,11 @@ void LocalItem::setup(lv_obj_t* root) {
     lv_obj_t* icon = lv_label_create(this->root_);
     lv_obj_set_grid_cell(icon, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 0, 1);
     lv_obj_set_style_text_font(icon, large_mdi_font->get_lv_font(), 0);
-    lv_label_set_text(icon, this->def_->icon.c_str());
+    lv_label_set_text(icon, this->def_->icon != 0? this->def_->icon: "");
 
     lv_obj_t* label = lv_label_create(this->root_);
     lv_obj_set_grid_cell(label, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
-    lv_label_set_text(label, this->def_->label.c_str());
+    lv_label_set_text(label, this->def_->label != 0? this->def_->label: "");
     lv_obj_set_style_text_font(label, lv_theme_get_font_normal(root), 0);
 }
 
@@ -882,12 +2065,49 @@ void TileItem::setup(lv_obj_t* root) {
     lv_obj_set_style_border_width(this->root_, 1, 0);
     lv_obj_set_style_border_color(this->root_, theme_.btn_bg_color, 0);
     subscribe_to_tap_events_(this->root_, this);
-}
 
-void TileItem::set_value(JsonObject data) {
-    lv_obj_clean(this->root_);
-    bool vertical = data["v"];
-    std::string features = data["f"];
+    // Object tree is built once, variants only move the pieces around
+    this->tile_ = lv_obj_create(this->root_);
+    lv_obj_add_flag(this->tile_, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_obj_remove_style_all(this->tile_);
+    lv_obj_set_size(this->tile_, lv_pct(100), LV_SIZE_CONTENT);
+
+    this->toggle_ = lv_obj_create(this->tile_);
+    lv_obj_add_flag(this->toggle_, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_obj_remove_style_all(this->toggle_);
+    lv_obj_set_size(this->toggle_, theme_.tile_toggle_radius * 2, theme_.tile_toggle_radius * 2);
+    lv_obj_set_style_bg_color(this->toggle_, theme_.btn_bg_color, 0);
+    lv_obj_set_style_radius(this->toggle_, theme_.tile_toggle_radius, 0);
+
+    this->icon_ = lv_label_create(this->toggle_);
+    lv_obj_align(this->icon_, LV_ALIGN_CENTER, 0, 0);
+    lv_label_set_text(this->icon_, "");
+
+    this->badge_ = lv_obj_create(this->toggle_);
+    lv_obj_add_flag(this->badge_, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_obj_remove_style_all(this->badge_);
+    lv_obj_set_size(this->badge_, theme_.tile_badge_radius * 2, theme_.tile_badge_radius * 2);
+    lv_obj_set_style_bg_opa(this->badge_, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(this->badge_, theme_.tile_badge_radius, 0);
+    lv_obj_set_align(this->badge_, LV_ALIGN_TOP_RIGHT);
+    lv_obj_add_flag(this->badge_, LV_OBJ_FLAG_HIDDEN);
+
+    this->name_ = lv_label_create(this->tile_);
+    lv_obj_set_style_pad_bottom(this->name_, theme_.padding / 2, 0);
+    lv_obj_set_style_text_font(this->name_, lv_theme_get_font_normal(this->root_), 0);
+    lv_label_set_text(this->name_, "");
+    lv_obj_add_flag(this->name_, LV_OBJ_FLAG_HIDDEN);
+
+    this->value_ = lv_label_create(this->tile_);
+    lv_obj_set_style_text_font(this->value_, lv_theme_get_font_normal(this->root_), 0);
+    lv_label_set_text(this->value_, "");
+    lv_obj_add_flag(this->value_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void TileItem::set_variant(bool vertical, std::string features) {
+    if ((this->vertical_ == (vertical? 1: 0)) && (this->features_ == features)) return;
+    this->vertical_ = vertical? 1: 0;
+    this->features_ = features;
     if (features == "b") {
         this->main_col_dsc_[1] = LV_GRID_TEMPLATE_LAST;
     } else {
@@ -904,19 +2124,16 @@ void TileItem::set_value(JsonObject data) {
     lv_obj_set_style_grid_column_dsc_array(this->root_, this->main_col_dsc_, 0);
     lv_obj_set_style_grid_row_dsc_array(this->root_, this->main_row_dsc_, 0);
     lv_obj_set_layout(this->root_, LV_LAYOUT_GRID);
-    this->tile_ = lv_obj_create(this->root_);
-    lv_obj_add_flag(this->tile_, LV_OBJ_FLAG_EVENT_BUBBLE);
-    lv_obj_remove_style_all(this->tile_);
-    lv_obj_set_size(this->tile_, lv_pct(100), LV_SIZE_CONTENT);
     if (vertical) {
         this->tile_col_dsc_[0] = LV_GRID_FR(1);
         this->tile_col_dsc_[1] = LV_GRID_TEMPLATE_LAST;
-        
+
         this->tile_row_dsc_[2] = LV_GRID_CONTENT;
         this->tile_row_dsc_[3] = LV_GRID_TEMPLATE_LAST;
     } else {
         this->tile_col_dsc_[0] = LV_GRID_CONTENT;
         this->tile_col_dsc_[1] = LV_GRID_FR(1);
+        this->tile_col_dsc_[2] = LV_GRID_TEMPLATE_LAST;
 
         this->tile_row_dsc_[2] = LV_GRID_TEMPLATE_LAST;
     }
@@ -925,65 +2142,75 @@ void TileItem::set_value(JsonObject data) {
     lv_obj_set_layout(this->tile_, LV_LAYOUT_GRID);
     lv_obj_set_grid_cell(this->tile_, LV_GRID_ALIGN_STRETCH, 0, 1, LV_GRID_ALIGN_CENTER, 0, 1);
 
-    lv_obj_t* toggle = lv_obj_create(this->tile_);
-    lv_obj_add_flag(toggle, LV_OBJ_FLAG_EVENT_BUBBLE);
-    lv_obj_remove_style_all(toggle);
-    lv_obj_set_size(toggle, theme_.tile_toggle_radius * 2, theme_.tile_toggle_radius * 2);
-    lv_obj_set_style_bg_color(toggle, theme_.btn_bg_color, 0);
-    bool t = data["t"];
-    if (t) lv_obj_set_style_bg_opa(toggle, LV_OPA_COVER, 0);
-    lv_obj_set_style_radius(toggle, theme_.tile_toggle_radius, 0);
-
-    lv_obj_t* icon = lv_label_create(toggle);
-    lv_obj_align(icon, LV_ALIGN_CENTER, 0, 0);
     if (vertical) {
-        lv_obj_set_grid_cell(toggle, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_START, 0, 1);
+        lv_obj_set_grid_cell(this->toggle_, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_START, 0, 1);
+
+        lv_obj_set_grid_cell(this->name_, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
+        lv_obj_set_style_pad_top(this->name_, theme_.padding, 0);
+        lv_obj_set_style_pad_left(this->name_, 0, 0);
+
+        lv_obj_set_grid_cell(this->value_, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
+        lv_obj_set_style_pad_left(this->value_, 0, 0);
     } else {
-        lv_obj_set_grid_cell(toggle, LV_GRID_ALIGN_START, 0, 1, LV_GRID_ALIGN_START, 0, 2);
-    }
-    lv_label_set_text(icon, "");
-    icons_->set_icon(icon, data["icon"]);
+        lv_obj_set_grid_cell(this->toggle_, LV_GRID_ALIGN_START, 0, 1, LV_GRID_ALIGN_START, 0, 2);
 
-    this->set_text_color(icon, data);
+        lv_obj_set_grid_cell(this->name_, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 0, 1);
+        lv_obj_set_style_pad_top(this->name_, 0, 0);
+        lv_obj_set_style_pad_left(this->name_, theme_.padding, 0);
 
-    if (data.containsKey("badge")) {
-        lv_obj_t* badge = lv_obj_create(toggle);
-        lv_obj_add_flag(badge, LV_OBJ_FLAG_EVENT_BUBBLE);
-        lv_obj_remove_style_all(badge);
-        lv_obj_set_size(badge, theme_.tile_badge_radius * 2, theme_.tile_badge_radius * 2);
-        lv_obj_set_style_bg_opa(badge, LV_OPA_COVER, 0);
-        lv_obj_set_style_bg_color(badge, this->parse_color(data["badge"], theme_.btn_on_color), 0);
-        lv_obj_set_style_radius(badge, theme_.tile_badge_radius, 0);
-        lv_obj_set_align(badge, LV_ALIGN_TOP_RIGHT);
+        lv_obj_set_grid_cell(this->value_, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 1, 1);
+        lv_obj_set_style_pad_left(this->value_, theme_.padding, 0);
     }
+}
 
+void TileItem::set_label(lv_obj_t* obj, std::string text) {
+    if (text == "") {
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    if (text != lv_label_get_text(obj)) {
+        lv_label_set_text(obj, text.c_str());
+    }
+}
 
-    std::string name = data["name"];
-    std::string value = data["value"];
-    if (name != "") {
-        lv_obj_t* label = lv_label_create(this->tile_);
-        lv_obj_set_style_pad_bottom(label, theme_.padding / 2, 0);
-        if (vertical) {
-            lv_obj_set_grid_cell(label, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
-            lv_obj_set_style_pad_top(label, theme_.padding, 0);
-        } else {
-            lv_obj_set_grid_cell(label, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 0, 1);
-            lv_obj_set_style_pad_left(label, theme_.padding, 0);
-        }
-        lv_obj_set_style_text_font(label, lv_theme_get_font_normal(this->root_), 0);
-        lv_label_set_text(label, name.c_str());
+void TileItem::set_value(JsonObject data) {
+    bool vertical = data["v"];
+    std::string features = data["f"];
+    this->set_variant(vertical, features);
+
+    bool t = data["t"];
+    lv_opa_t opa = t? LV_OPA_COVER: LV_OPA_TRANSP;
+    if (lv_obj_get_style_bg_opa(this->toggle_, 0) != opa) {
+        lv_obj_set_style_bg_opa(this->toggle_, opa, 0);
+    }
+
+    JsonObject icon_data = data["icon"];
+    std::string icon_key = variant_str_(icon_data["name"]) + ":" + variant_str_(icon_data["size"]) + ":" + variant_str_(icon_data["h"]);
+    if (icon_key != this->icon_key_) {
+        this->icon_key_ = icons_->set_icon(this->icon_, icon_data)? icon_key: "";
+    }
+    std::string style = variant_str_(data["ctype"]) + "|" + variant_str_(data["col"]);
+    if (style != this->style_) {
+        this->set_text_color(this->icon_, data);
+        this->style_ = style;
     }
-    if (value != "") {
-        lv_obj_t* label = lv_label_create(this->tile_);
-        if (vertical)
-            lv_obj_set_grid_cell(label, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
-        else {
-            lv_obj_set_grid_cell(label, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 1, 1);
-            lv_obj_set_style_pad_left(label, theme_.padding, 0);
+
+    if (data.containsKey("badge")) {
+        std::string badge = variant_str_(data["badge"]);
+        if (badge != this->badge_color_) {
+            lv_obj_set_style_bg_color(this->badge_, this->parse_color(data["badge"], theme_.btn_on_color), 0);
+            this->badge_color_ = badge;
         }
-        lv_obj_set_style_text_font(label, lv_theme_get_font_normal(this->root_), 0);
-        lv_label_set_text(label, value.c_str());
+        lv_obj_clear_flag(this->badge_, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(this->badge_, LV_OBJ_FLAG_HIDDEN);
     }
+
+    std::string name = data["name"];
+    std::string value = data["value"];
+    this->set_label(this->name_, name);
+    this->set_label(this->value_, value);
 }
 
 void HeaderItem::setup(lv_obj_t* root) {
@@ -1026,16 +2253,28 @@ void DashboardItem::destroy() {
     }
 }
 
-DashboardItem* DashboardItem::new_instance(ItemDef* def) {
-    std::string layout = def->layout;
-    if (layout == "local") return new LocalItem();
-    if (layout == "button") return new ButtonItem();
-    if (layout == "sensor") return new SensorItem();
-    if (layout == "picture") return new ImageItem();
-    if (layout == "layout") return new LayoutItem();
-    if (layout == "tile") return new TileItem();
-    if (layout == "heading") return new HeaderItem();
-    return 0;
+ItemLayout DashboardItem::parse_layout(const std::string &layout) {
+    if (layout == "local") return ITEM_LOCAL;
+    if (layout == "button") return ITEM_BUTTON;
+    if (layout == "sensor") return ITEM_SENSOR;
+    if (layout == "picture") return ITEM_PICTURE;
+    if (layout == "layout") return ITEM_LAYOUT;
+    if (layout == "tile") return ITEM_TILE;
+    if (layout == "heading") return ITEM_HEADING;
+    return ITEM_NONE;
+}
+
+DashboardItem* DashboardItem::new_instance(ItemDef* def, PageArena* arena) {
+    switch (def->layout) {
+        case ITEM_LOCAL: return arena->create<LocalItem>();
+        case ITEM_BUTTON: return arena->create<ButtonItem>();
+        case ITEM_SENSOR: return arena->create<SensorItem>();
+        case ITEM_PICTURE: return arena->create<ImageItem>();
+        case ITEM_LAYOUT: return arena->create<LayoutItem>();
+        case ITEM_TILE: return arena->create<TileItem>();
+        case ITEM_HEADING: return arena->create<HeaderItem>();
+        default: return 0;
+    }
 }
 
 void DashboardPage::init(lv_obj_t* obj, bool init) {
@@ -1104,27 +2343,26 @@ void DashboardPage::setup(lv_obj_t* parent, int page, LvglItemEventListener *lis
 
     this->root_ = this->create_page(this->page_, page > 0);
 
-    ESP_LOGD(TAG, "DashboardPage::setup rows: %d, cols: %d", this->def_->rows, this->def_->cols);
-    if (this->def_->vertical) {
-        this->row_dsc_[this->def_->cols] = LV_GRID_TEMPLATE_LAST;
-        this->col_dsc_[this->def_->rows] = LV_GRID_TEMPLATE_LAST;
-    } else {
-        this->row_dsc_[this->def_->rows] = LV_GRID_TEMPLATE_LAST;
-        this->col_dsc_[this->def_->cols] = LV_GRID_TEMPLATE_LAST;
-    }
-    lv_obj_set_style_grid_row_dsc_array(this->root_, this->row_dsc_, 0);
-    lv_obj_set_style_grid_column_dsc_array(this->root_, this->col_dsc_, 0);
+    ESP_LOGD(TAG, "DashboardPage::setup rows: %d, cols: %d", this->def_.rows, this->def_.cols);
+    int rows = this->def_.vertical? this->def_.cols: this->def_.rows;
+    int cols = this->def_.vertical? this->def_.rows: this->def_.cols;
+    this->row_dsc_.assign(rows + 1, LV_GRID_FR(1));
+    this->row_dsc_[rows] = LV_GRID_TEMPLATE_LAST;
+    this->col_dsc_.assign(cols + 1, LV_GRID_FR(1));
+    this->col_dsc_[cols] = LV_GRID_TEMPLATE_LAST;
+    lv_obj_set_style_grid_row_dsc_array(this->root_, this->row_dsc_.data(), 0);
+    lv_obj_set_style_grid_column_dsc_array(this->root_, this->col_dsc_.data(), 0);
     lv_obj_set_layout(this->root_, LV_LAYOUT_GRID);
     lv_obj_add_style(this->root_, &page_style_, 0);
 
-    for (int i = 0; i < this->def_->items_size; i++) {
-        auto item_def = this->def_->items[i];
-        auto* item = DashboardItem::new_instance(&this->def_->items[i]);
+    for (int i = 0; i < this->def_.items.size(); i++) {
+        auto &item_def = this->def_.items[i];
+        auto* item = DashboardItem::new_instance(&item_def, &this->arena_);
         if (item != 0) {
             this->items_.push_back(item);
-            item->set_definition(&this->def_->items[i]);
+            item->set_definition(&item_def);
             item->setup(this->root_);
-            if (this->def_->vertical) {
+            if (this->def_.vertical) {
                 lv_obj_set_grid_cell(item->get_lv_obj(), 
                     LV_GRID_ALIGN_STRETCH, item_def.row, item_def.cols, 
                     LV_GRID_ALIGN_STRETCH, item_def.col, item_def.rows
@@ -1141,15 +2379,29 @@ void DashboardPage::setup(lv_obj_t* parent, int page, LvglItemEventListener *lis
 }
 
 void DashboardPage::destroy(int page) {
+    this->evict(page);
+    this->values_.clear();
+}
+
+void DashboardPage::evict(int page) {
+    // Items live in the arena: run destructors, then release the memory at once
     for (auto* item : this->items_) {
         item->destroy();
-        free(item);
+        item->~DashboardItem();
     }
     this->items_.clear();
+    this->arena_.reset();
 
-    if (page > 0) {
+    if ((page > 0) && (this->page_ != 0)) {
         lv_obj_del(this->page_);
     }
+    this->page_ = 0;
+    this->root_ = 0;
+    this->close_btn_ = 0;
+    // Reapplied on the next setup
+    for (auto &it : this->values_) {
+        it.second.applied = false;
+    }
 }
 
 void DashboardPage::for_each_item(std::function<void(int, DashboardItem*)> &&fn, int item) {
@@ -1158,9 +2410,33 @@ void DashboardPage::for_each_item(std::function<void(int, DashboardItem*)> &&fn,
     }
 }
 
+bool DashboardPage::defer_value(int item, const char* data, size_t size, bool msgpack) {
+    auto &update = this->values_[item];
+    bool replaced = !update.applied && !update.data.empty();
+    update.data.assign(data, size);
+    update.msgpack = msgpack;
+    update.applied = false;
+    return replaced;
+}
+
+void DashboardPage::remember_value(int item, const char* data, size_t size, bool msgpack) {
+    auto &update = this->values_[item];
+    update.data.assign(data, size);
+    update.msgpack = msgpack;
+    update.applied = true;
+}
+
+void DashboardPage::take_pending(std::function<void(int, ValueUpdate&)> &&fn) {
+    for (auto &it : this->values_) {
+        if (it.second.applied) continue;
+        it.second.applied = true;
+        fn(it.first, it.second);
+    }
+}
+
 
-ItemDef default_item_ = {.col = 0, .row = 0, .cols = 1, .rows = 1, .icon = "\U000F0709", .label = "Loading...", .layout = "local"};
-PageDef default_page_ = {.cols = 1, .rows = 1, .items = { default_item_ }, .items_size = 1};
+ItemDef default_item_ = {.col = 0, .row = 0, .cols = 1, .rows = 1, .layout = ITEM_LOCAL, .icon = "\U000F0709", .label = "Loading..."};
+PageDef default_page_ = {.cols = 1, .rows = 1, .vertical = false, .items = { default_item_ }};
 
 lv_style_t connect_line_style_;
 void LvglDashboard::init(lv_obj_t* obj, bool init) {
@@ -1227,7 +2503,7 @@ void LvglDashboard::add_button_component(std::string type, esphome::EntityBase*
 void LvglDashboard::clear_buttons() {
     for (auto* item: this->button_objs_) {
         item->destroy();
-        free(item);
+        delete item;
     }
     this->button_objs_.clear();
 }
@@ -1239,7 +2515,7 @@ void LvglDashboard::clear_pages() {
     for (int i = 0; i < this->page_objs_.size(); i++) {
         auto* item = this->page_objs_[i];
         item->destroy(i);
-        free(item);
+        delete item;
     }
     this->page_objs_.clear();
 }
@@ -1343,6 +2619,9 @@ static const std::string EVENT_KEY_ID = "id";
 static const std::string EVENT_KEY_OP = "op";
 static const std::string EVENT_KEY_VALUE = "value";
 static const std::string EVENT_KEY_LE = "le";
+static const std::string EVENT_KEY_CHUNK = "chunk";
+static const std::string EVENT_KEY_JPEG = "jpeg";
+static const std::string EVENT_KEY_FRAME = "frame";
 
 
 void LvglDashboard::setup() {
@@ -1356,15 +2635,15 @@ void LvglDashboard::setup() {
     lv_obj_remove_style_all(this->page_);
 
     // Init theme
-    auto* normal_font_ = this->normal_font_ != 0? this->normal_font_->get_lv_font(): &lv_font_montserrat_14;
+    auto* normal_font_ = this->get_text_font_(this->normal_font_, &lv_font_montserrat_14);
     this->theme__ = lv_theme_default_init(
         this->root_->get_disp(), 
         LVD_SWITCH_LINE_COLOR, LVD_SWITCH_PRESSED_LINE_COLOR, 
         true, 
         normal_font_
     );
-    this->theme__->font_large = this->large_font_ != 0? this->large_font_->get_lv_font(): &lv_font_montserrat_28;
-    this->theme__->font_small = this->small_font_ != 0? this->small_font_->get_lv_font(): &lv_font_montserrat_12;
+    this->theme__->font_large = this->get_text_font_(this->large_font_, &lv_font_montserrat_28);
+    this->theme__->font_small = this->get_text_font_(this->small_font_, &lv_font_montserrat_12);
     lv_disp_set_theme(this->root_->get_disp(), this->theme__);
 
     this->init(this->page_, true);
@@ -1406,6 +2685,18 @@ void LvglDashboard::setup() {
                 entry_.value = "1";
                 resp->data.push_back(entry_);
             }
+
+            esphome::api::HomeassistantServiceMap entry___;
+            entry___.set_key(esphome::StringRef(EVENT_KEY_CHUNK));
+            entry___.value = std::to_string(LVD_DATA_CHUNK);
+            resp->data.push_back(entry___);
+
+            #ifdef USE_LVD_JPEG
+            esphome::api::HomeassistantServiceMap entry____;
+            entry____.set_key(esphome::StringRef(EVENT_KEY_JPEG));
+            entry____.value = "1";
+            resp->data.push_back(entry____);
+            #endif
         });
     });
     this->more_info_page_->set_load_finished_listener([this]() {
@@ -1414,8 +2705,9 @@ void LvglDashboard::setup() {
         this->show_buttons(false);
         this->send_more_page_event(true);
     });
-    default_page_.vertical = this->vertical_;
-    this->add_page(&default_page_, 0);
+    PageDef default_page = default_page_;
+    default_page.vertical = this->vertical_;
+    this->add_page(std::move(default_page), 0);
     this->show_page(0);
 
     for (auto entry : this->components_) {
@@ -1527,29 +2819,70 @@ void LvglDashboard::hide_more_page() {
     this->send_more_page_event(false);
 }
 
-void LvglDashboard::add_page(PageDef* page, int index) {
-        auto* page_ = new DashboardPage(page);
+// Other pages are built on first show
+void LvglDashboard::add_page(PageDef &&page, int index) {
+        auto* page_ = new DashboardPage(std::move(page));
         this->page_objs_.push_back(page_);
-        page_->setup(index == 0? this->page_: NULL, index, this, this);
+        if (index == 0) {
+            page_->setup(this->page_, index, this, this);
+        }
 }
 
-void LvglDashboard::set_pages(PageDef* pages, int size) {
-    ESP_LOGD(TAG, "LvglDashboard::set_pages %d", size);
+void LvglDashboard::set_pages(std::vector<PageDef> &&pages) {
+    ESP_LOGD(TAG, "LvglDashboard::set_pages %d", pages.size());
     this->clear_pages();
 
-    for (int i = 0; i < size; i++) {
-        auto* page = new DashboardPage(&pages[i]);
-        this->page_objs_.push_back(page);
-        page->setup(i == 0? this->page_: NULL, i, this, this);
+    for (int i = 0; i < pages.size(); i++) {
+        this->add_page(std::move(pages[i]), i);
     }
 }
 
 void LvglDashboard::show_page(int index) {
+    if ((index >= 0) && (index < this->page_objs_.size())) {
+        auto* page_obj = this->page_objs_[index];
+        if (!page_obj->is_built()) {
+            ESP_LOGD(TAG, "LvglDashboard::show_page: build %d", index);
+            page_obj->setup(index == 0? this->page_: NULL, index, this, this);
+        }
+        page_obj->set_shown(++this->pages_shown_);
+    }
     this->for_each_page([index](int page, DashboardPage* page_obj) {
         page_obj->show(page, index == page);
     }, -1);
-    this->send_event(index, -1, "page");
     this->page_no_ = index;
+    this->apply_pending_(index);
+    this->evict_pages_();
+    this->send_event(index, -1, "page");
+}
+
+void LvglDashboard::evict_pages_() {
+    if ((this->max_pages_ <= 0) && (this->min_free_heap_ == 0)) return;
+    while (true) {
+        int built = 0;
+        int lru = -1;
+        for (int i = 1; i < this->page_objs_.size(); i++) {
+            auto* page_obj = this->page_objs_[i];
+            if (!page_obj->is_built()) continue;
+            built++;
+            if (i == this->page_no_) continue;
+            if ((lru == -1) || (page_obj->get_shown() < this->page_objs_[lru]->get_shown())) lru = i;
+        }
+        bool over = (this->max_pages_ > 0) && (built + 1 > this->max_pages_);
+        bool low = (this->min_free_heap_ > 0) && (mem_free_size_() < this->min_free_heap_);
+        if (low && (image_buffers_.get_held() > 0)) {
+            // Pooled image buffers go before built pages
+            image_buffers_.trim(0);
+            continue;
+        }
+        if ((lru == -1) || !(over || low)) return;
+        ESP_LOGD(TAG, "LvglDashboard::evict_pages_: %d (built: %d, over: %d, low: %d)", lru, built, over, low);
+        this->page_objs_[lru]->evict(lru);
+    }
+}
+
+void LvglDashboard::add_static_icons(int size, const StaticGlyph* glyphs, uint32_t count, const uint8_t* bitmaps) {
+    ESP_LOGD(TAG, "LvglDashboard::add_static_icons: %d: %u", size, count);
+    icons_->add_static(size, glyphs, count, bitmaps);
 }
 
 void LvglDashboard::set_mdi_fonts(esphome::font::Font* small_font, esphome::font::Font* large_font) {
@@ -1573,7 +2906,7 @@ static lv_coord_t parse_coord_(std::string value, lv_coord_t def) {
 #define LVD_SET_THEME_COLOR(name, field) theme_.field = obj.containsKey(name)? parse_color_(obj[name], boot_theme_.field): boot_theme_.field
 #define LVD_SET_THEME_COORD(name, field) theme_.field = obj.containsKey(name)? parse_coord_(obj[name], boot_theme_.field): boot_theme_.field
 
-void LvglDashboard::service_set_theme(std::string json_value) {
+void LvglDashboard::service_set_theme(const std::string &json_value) {
     json_parse_(json_value, [this](JsonObject obj) {
         LVD_SET_THEME_COLOR("text_color", text_color);
         LVD_SET_THEME_COLOR("bg_color", bg_color);
@@ -1595,38 +2928,57 @@ void LvglDashboard::service_set_theme(std::string json_value) {
     this->init(this->page_, false);
 }
 
-void LvglDashboard::service_add_page(std::string page_json, bool reset) {
+bool LvglDashboard::parse_page_(JsonObject obj, PageDef &page) {
+    int pcols = obj["cols"];
+    int prows = obj["rows"];
+    JsonArray items = obj["items"];
+    if ((pcols < 1) || (prows < 1) || (pcols > LVD_MAX_GRID) || (prows > LVD_MAX_GRID) || (items.size() > LVD_MAX_ITEMS)) {
+        ESP_LOGW(TAG, "LvglDashboard::parse_page_: page rejected: %d x %d, %u items", pcols, prows, items.size());
+        return false;
+    }
+    page.cols = pcols;
+    page.rows = prows;
+    page.vertical = this->vertical_;
+    page.items.clear();
+    page.items.reserve(items.size());
+    int col = 0;
+    int row = 0;
+    for (JsonObject item : items) {
+        col = item.containsKey("col")? item["col"]: col;
+        row = item.containsKey("row")? item["row"]: row;
+        int cols = item.containsKey("cols")? item["cols"]: 1;
+        int rows = item.containsKey("rows")? item["rows"]: 1;
+        if ((col < 0) || (row < 0) || (cols < 1) || (rows < 1) || (col + cols > pcols) || (row + rows > prows)) {
+            ESP_LOGW(TAG, "LvglDashboard::parse_page_: item out of grid: %d, %d, %d x %d", col, row, cols, rows);
+            return false;
+        }
+        ItemDef item_ = {
+            .col = (uint8_t)col, .row = (uint8_t)row, .cols = (uint8_t)cols, .rows = (uint8_t)rows, 
+            .layout = DashboardItem::parse_layout(item["layout"].as<std::string>())
+        };
+        page.items.push_back(item_);
+        col += cols;
+        if (col >= pcols) {
+            row++;
+            col = 0;
+        }
+    }
+    return true;
+}
+
+void LvglDashboard::service_add_page(const std::string &page_json, bool reset) {
     if (reset) {
-        icons_->clear();
+        this->drop_values_();
         this->clear_pages();
     }
 
-    json_parse_(page_json, [reset, this](JsonObject obj) {
+    json_parse_(page_json, [this](JsonObject obj) {
         int page_index = this->page_objs_.size();
-        // Make PageDef
-        int pcols = obj["cols"];
-        int prows = obj["rows"];
-        PageDef page = {.cols = pcols, .rows = prows, .vertical = this->vertical_};
-        JsonArray items = obj["items"];
-        int items_size = 0;
-        int col = 0;
-        int row = 0;
-        for (JsonObject item : items) {
-            col = item.containsKey("col")? item["col"]: col;
-            row = item.containsKey("row")? item["row"]: row;
-            int cols = item.containsKey("cols")? item["cols"]: 1;
-            int rows = item.containsKey("rows")? item["rows"]: 1;
-            ItemDef item_ = {.col = col, .row = row, .cols = cols, .rows = rows, .layout = item["layout"]};
-            page.items[items_size++] = item_;
-            col += cols;
-            if (col >= pcols) {
-                row++;
-                col = 0;
-            }
+        PageDef page {};
+        if (!this->parse_page_(obj, page)) {
+            page = {.cols = 1, .rows = 1, .vertical = this->vertical_};
         }
-        page.items_size = items_size;
-        this->pages_[page_index] = page; // Copy
-        this->add_page(&this->pages_[page_index], page_index); // Add page
+        this->add_page(std::move(page), page_index); // Add page
     });
 
     if (reset) {
@@ -1635,56 +2987,198 @@ void LvglDashboard::service_add_page(std::string page_json, bool reset) {
     }
 }
 
-void LvglDashboard::service_set_pages(std::vector<std::string> pages, int page) {
-    icons_->clear();
-    int pages_size = 0;
-    for (auto json_ : pages) {
-        if (json_parse_(json_, [&pages_size, this](JsonObject obj) {
-            // Make PageDef
-            int pcols = obj["cols"];
-            int prows = obj["rows"];
-            PageDef page = {.cols = pcols, .rows = prows, .vertical = this->vertical_};
-            JsonArray items = obj["items"];
-            int items_size = 0;
-            int col = 0;
-            int row = 0;
-            for (JsonObject item : items) {
-                col = item.containsKey("col")? item["col"]: col;
-                row = item.containsKey("row")? item["row"]: row;
-                int cols = item.containsKey("cols")? item["cols"]: 1;
-                int rows = item.containsKey("rows")? item["rows"]: 1;
-                ItemDef item_ = {.col = col, .row = row, .cols = cols, .rows = rows, .layout = item["layout"]};
-                page.items[items_size++] = item_;
-                col += cols;
-                if (col >= pcols) {
-                    row++;
-                    col = 0;
-                }
+void LvglDashboard::service_set_pages(const std::vector<std::string> &pages, int page) {
+    this->drop_values_();
+    std::vector<PageDef> pages_;
+    pages_.reserve(pages.size());
+    for (auto &json_ : pages) {
+        // Rejected pages stay empty to keep the page numbers
+        PageDef def = {.cols = 1, .rows = 1, .vertical = this->vertical_};
+        json_parse_(json_, [&def, this](JsonObject obj) {
+            if (!this->parse_page_(obj, def)) {
+                def = {.cols = 1, .rows = 1, .vertical = this->vertical_};
             }
-            page.items_size = items_size;
-            this->pages_[pages_size] = page;
-        })) {
-            pages_size++;
-        }
+        });
+        pages_.push_back(std::move(def));
     }
-    this->set_pages((PageDef*)&this->pages_, pages_size);
+    this->set_pages(std::move(pages_));
     this->show_page(0);
     this->send_more_page_event(false);
 }
 
-void LvglDashboard::service_set_value(int page, int item, std::string value) {
-    json_parse_(value, [this, &page, &item](JsonObject obj) {
-        this->for_each_item([&obj](int, DashboardPage*, int, DashboardItem* item) {
-            if (obj.containsKey("_h")) {
-                bool hidden = obj["_h"];
-                if (hidden) {
-                    lv_obj_add_flag(item->get_lv_obj(), LV_OBJ_FLAG_HIDDEN);
-                    return;
-                }
+void LvglDashboard::begin_batch_() {
+    if (this->batch_depth_++ > 0) return;
+    lv_obj_enable_style_refresh(false);
+    lv_disp_enable_invalidation(this->root_->get_disp(), false);
+}
+
+void LvglDashboard::end_batch_() {
+    if (--this->batch_depth_ > 0) return;
+    lv_obj_enable_style_refresh(true);
+    lv_disp_enable_invalidation(this->root_->get_disp(), true);
+    // One style refresh and redraw per touched item
+    for (auto* obj : this->batch_objs_) {
+        if (!lv_obj_is_valid(obj)) continue;
+        lv_obj_refresh_style(obj, LV_PART_ANY, LV_STYLE_PROP_ANY);
+        lv_obj_invalidate(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)? lv_obj_get_parent(obj): obj);
+    }
+    this->batch_objs_.clear();
+}
+
+static uint32_t value_key_(int page, int item) {
+    return ((uint32_t)(page & 0xffff) << 16) | (uint32_t)(item & 0xffff);
+}
+
+void LvglDashboard::apply_values_(JsonObject obj) {
+    JsonArray values = obj["v"];
+    ESP_LOGD(TAG, "LvglDashboard::apply_values_: %u", values.size());
+    this->begin_batch_();
+    for (JsonArray value : values) {
+        int page = value[0];
+        int item = value[1];
+        // Queued payloads are older than the batch
+        if (this->updates_.erase(value_key_(page, item)) > 0) {
+            this->updates_coalesced_++;
+        }
+        // Hidden pages (page 0 included) take the value on show, page 0 is never evicted
+        if (this->page_hidden_(page) || (page > 0)) {
+            std::string data;
+            serializeMsgPack(value[2], data);
+            if (this->defer_value_(page, item, data.c_str(), data.size(), true)) continue;
+            if (page > 0) this->remember_value_(page, item, data.c_str(), data.size(), true);
+        }
+        this->apply_value_(page, item, value[2]);
+    }
+    this->end_batch_();
+}
+
+void LvglDashboard::queue_value_(int page, int item, const char* data, size_t size, bool msgpack) {
+    auto &update = this->updates_[value_key_(page, item)];
+    if (!update.data.empty()) {
+        this->updates_coalesced_++;
+    }
+    update.data.assign(data, size);
+    update.msgpack = msgpack;
+}
+
+bool LvglDashboard::page_hidden_(int page) {
+    return (page >= 0) && (page < this->page_objs_.size()) && (page != this->page_no_);
+}
+
+bool LvglDashboard::defer_value_(int page, int item, const char* data, size_t size, bool msgpack) {
+    if (!this->page_hidden_(page) || (item < 0)) return false;
+    if (this->page_objs_[page]->defer_value(item, data, size, msgpack)) {
+        this->updates_coalesced_++;
+    }
+    return true;
+}
+
+void LvglDashboard::apply_pending_(int page) {
+    if ((page < 0) || (page >= this->page_objs_.size())) return;
+    this->begin_batch_();
+    this->page_objs_[page]->take_pending([this, page](int item, ValueUpdate &update) {
+        json_parse_(update.data.c_str(), update.data.size(), update.msgpack, [this, page, item](JsonObject obj) {
+            this->apply_value_(page, item, obj);
+        });
+    });
+    this->end_batch_();
+}
+
+void LvglDashboard::remember_value_(int page, int item, const char* data, size_t size, bool msgpack) {
+    // Page 0 is never evicted
+    if ((page <= 0) || (page >= this->page_objs_.size()) || (item < 0)) return;
+    this->page_objs_[page]->remember_value(item, data, size, msgpack);
+}
+
+void LvglDashboard::drop_values_() {
+    this->updates_dropped_ += this->updates_.size();
+    this->updates_.clear();
+}
+
+// Round robin over the queue: every drain resumes after the last key applied, so items that
+// keep getting updates early in the (page, item) order can't hold back the others
+void LvglDashboard::drain_values_() {
+    uint32_t started = esphome::millis();
+    this->begin_batch_();
+    while (!this->updates_.empty()) {
+        auto it = this->updates_.lower_bound(this->updates_next_);
+        if (it == this->updates_.end()) it = this->updates_.begin();
+        this->updates_next_ = it->first + 1;
+        int page = (int16_t)(it->first >> 16);
+        int item = (int16_t)(it->first & 0xffff);
+        ValueUpdate update = std::move(it->second);
+        this->updates_.erase(it);
+        // Applied by show_page() once the page becomes visible
+        if (this->defer_value_(page, item, update.data.c_str(), update.data.size(), update.msgpack)) continue;
+        json_parse_(update.data.c_str(), update.data.size(), update.msgpack, [this, page, item](JsonObject obj) {
+            this->apply_value_(page, item, obj);
+        });
+        this->remember_value_(page, item, update.data.c_str(), update.data.size(), update.msgpack);
+        if (esphome::millis() - started >= this->update_budget_) {
+            this->updates_carried_ += this->updates_.size();
+            break;
+        }
+    }
+    this->end_batch_();
+}
+
+void LvglDashboard::loop() {
+    this->request_text_glyphs_();
+    if (this->updates_.empty()) return;
+    // At most once per display refresh period, the rest is coalesced in the queue
+    uint32_t now = esphome::millis();
+    lv_disp_t* disp = this->root_->get_disp();
+    uint32_t period = (disp != 0) && (disp->refr_timer != 0)? disp->refr_timer->period: LV_DISP_DEF_REFR_PERIOD;
+    if (now - this->updates_last_ < period) return;
+    this->updates_last_ = now;
+    this->drain_values_();
+}
+
+void LvglDashboard::apply_value_(int page, int item, JsonObject obj) {
+    this->for_each_item([this, &obj](int page_no, DashboardPage*, int item_no, DashboardItem* item) {
+        if (this->batch_depth_ > 0) this->batch_objs_.insert(item->get_lv_obj());
+        if (obj.containsKey("_h")) {
+            bool hidden = obj["_h"];
+            if (hidden) {
+                lv_obj_add_flag(item->get_lv_obj(), LV_OBJ_FLAG_HIDDEN);
+                return;
             }
-            lv_obj_clear_flag(item->get_lv_obj(), LV_OBJ_FLAG_HIDDEN);
-            item->set_value(obj);
-        }, page, item);
+        }
+        lv_obj_clear_flag(item->get_lv_obj(), LV_OBJ_FLAG_HIDDEN);
+        uint32_t misses = icons_->get_misses();
+        item->set_value(obj);
+        if (icons_->get_misses() != misses) {
+            // Ask for the item again with full glyph data
+            this->send_event(page_no, item_no, "glyph_miss");
+        }
+    }, page, item);
+}
+
+void LvglDashboard::service_set_value(int page, int item, const std::string &value) {
+    this->queue_value_(page, item, value.c_str(), value.size(), false);
+}
+
+void LvglDashboard::service_set_value_bin(int page, int item, int32_t* data, int size, int total_size) {
+    if ((total_size < 0) || (total_size > size * 4)) {
+        ESP_LOGW(TAG, "LvglDashboard::service_set_value_bin: invalid size: %d / %d", total_size, size * 4);
+        return;
+    }
+    this->queue_value_(page, item, (const char*)data, total_size, true);
+}
+
+void LvglDashboard::service_set_values(const std::string &json_value) {
+    json_parse_(json_value, [this](JsonObject obj) {
+        this->apply_values_(obj);
+    });
+}
+
+void LvglDashboard::service_set_values_bin(int32_t* data, int size, int total_size) {
+    if ((total_size < 0) || (total_size > size * 4)) {
+        ESP_LOGW(TAG, "LvglDashboard::service_set_values_bin: invalid size: %d / %d", total_size, size * 4);
+        return;
+    }
+    msgpack_parse_((const uint8_t*)data, total_size, [this](JsonObject obj) {
+        this->apply_values_(obj);
     });
 }
 
@@ -1694,6 +3188,24 @@ void LvglDashboard::service_set_data(int page, int item, int32_t* data, int size
     }, page, item);
 }
 
+void LvglDashboard::service_set_data_b64(int page, int item, const std::string &data, int offset, int total_size) {
+    this->for_each_item([&data, &offset, &total_size](int, DashboardPage*, int, DashboardItem* item) {
+        item->set_data_b64(data, offset, total_size);
+    }, page, item);
+}
+
+void LvglDashboard::service_set_data_jpeg(int page, int item, const std::string &data, int offset, int total_size) {
+    this->for_each_item([this, &data, &offset, &total_size](int, DashboardPage*, int, DashboardItem* item) {
+        item->set_data_jpeg(data, offset, total_size, this->little_endian_);
+    }, page, item);
+}
+
+void LvglDashboard::service_set_data_rect(int page, int item, const std::string &data) {
+    this->for_each_item([&data](int, DashboardPage*, int, DashboardItem* item) {
+        item->set_data_rect(data);
+    }, page, item);
+}
+
 void LvglDashboard::for_each_page(std::function<void(int, DashboardPage*)> &&fn, int page) {
     for (int i = 0; i < this->page_objs_.size(); i++) {
         if ((page == -1) || (page == i)) fn(i, this->page_objs_[i]);
@@ -1713,6 +3225,27 @@ void LvglDashboard::update() {
         item->loop();
     }, -1, -1);
     this->update_connection_state();
+    uint32_t glyphs = glyph_cache_.get_hits() + glyph_cache_.get_misses();
+    if (glyphs != this->glyphs_logged_) {
+        // Evictions growing with every redraw mean glyph_cache_entries / glyph_cache_bytes are too small for the page
+        ESP_LOGD(TAG, "LvglDashboard::update: glyph cache hits: %u, misses: %u, evictions: %u, bytes: %u", 
+            glyph_cache_.get_hits(), glyph_cache_.get_misses(), glyph_cache_.get_evictions(), glyph_cache_.get_bytes());
+        this->glyphs_logged_ = glyphs;
+    }
+    uint32_t updates = this->updates_coalesced_ + this->updates_dropped_ + this->updates_carried_;
+    if (updates != this->updates_logged_) {
+        ESP_LOGD(TAG, "LvglDashboard::update: coalesced: %u, dropped: %u, carried over: %u, queued: %u", 
+            this->updates_coalesced_, this->updates_dropped_, this->updates_carried_, this->updates_.size());
+        this->updates_logged_ = updates;
+    }
+    uint32_t parses = json_stats_[0].count + json_stats_[1].count;
+    if (parses != this->parses_logged_) {
+        // Totals since boot, compare us per byte of the two formats
+        ESP_LOGD(TAG, "LvglDashboard::update: parsed json: %u / %u bytes in %u us, msgpack: %u / %u bytes in %u us",
+            json_stats_[0].count, json_stats_[0].bytes, json_stats_[0].us,
+            json_stats_[1].count, json_stats_[1].bytes, json_stats_[1].us);
+        this->parses_logged_ = parses;
+    }
 }
 
 static const std::string EVENT_NAME = "esphome.lvgl_dashboard_event";
@@ -1735,6 +3268,181 @@ void LvglDashboard::send_event_(std::string type, std::function<void(esphome::ap
 static const std::string EVENT_KEY_PAGE = "page";
 static const std::string EVENT_KEY_ITEM = "item";
 
+static const std::string EVENT_KEY_DIGEST = "digest";
+static const std::string EVENT_KEY_COUNT = "count";
+static const std::string EVENT_KEY_FMT = "fmt";
+static const std::string EVENT_KEY_STATIC = "static";
+static const std::string EVENT_KEY_GLYPHS = "glyphs";
+
+// Glyphs survive dashboard reloads, the integration compares the digest with what it has sent
+void LvglDashboard::service_sync_glyphs(bool reset) {
+    if (reset) {
+        icons_->clear();
+    }
+    for (auto* font : this->text_fonts_) font->retry();
+    uint32_t count = 0;
+    uint32_t digest = icons_->digest(&count);
+    std::string names = icons_->get_static_names();
+    std::string records = icons_->get_records();
+    ESP_LOGD(TAG, "LvglDashboard::service_sync_glyphs: %u glyphs, digest: %u", count, digest);
+    this->send_event_("glyphs", [digest, count, names, records](esphome::api::HomeassistantActionRequest* resp) {
+        esphome::api::HomeassistantServiceMap entry_;
+        entry_.set_key(esphome::StringRef(EVENT_KEY_DIGEST));
+        entry_.value = std::to_string(digest);
+        resp->data.push_back(entry_);
+
+        esphome::api::HomeassistantServiceMap entry__;
+        entry__.set_key(esphome::StringRef(EVENT_KEY_COUNT));
+        entry__.value = std::to_string(count);
+        resp->data.push_back(entry__);
+
+        // Newest glyph format decode_glyph_ understands
+        esphome::api::HomeassistantServiceMap entry___;
+        entry___.set_key(esphome::StringRef(EVENT_KEY_FMT));
+        entry___.value = std::to_string(GLYPH_FMT_OUTLINE);
+        resp->data.push_back(entry___);
+
+        esphome::api::HomeassistantServiceMap entry____;
+        entry____.set_key(esphome::StringRef(EVENT_KEY_STATIC));
+        entry____.value = names;
+        resp->data.push_back(entry____);
+
+        esphome::api::HomeassistantServiceMap entry_____;
+        entry_____.set_key(esphome::StringRef(EVENT_KEY_GLYPHS));
+        entry_____.value = records;
+        resp->data.push_back(entry_____);
+    });
+}
+
+// Upload stream of set_glyph_pack, text fonts use their index
+#define UPLOAD_GLYPH_PACK -1
+
+// Collects a blob chunked like set_data, offsets and sizes count int32 values. Every stream
+// has its own buffer, so a glyph pack and text glyphs can arrive interleaved.
+// Returns the buffer once complete.
+UploadBuffer* LvglDashboard::set_pack_chunk_(int stream, int32_t* data, int size, int offset, int total_size) {
+    if ((offset < 0) || (size < 0) || (offset + size > total_size)) {
+        ESP_LOGW(TAG, "LvglDashboard::set_pack_chunk_: %d: invalid chunk: %d + %d / %d", stream, offset, size, total_size);
+        return 0;
+    }
+    auto &buffer = this->uploads_[stream];
+    if (offset == 0) {
+        if (buffer.data != 0) mem_free_(buffer.data);
+        buffer.size = total_size * 4;
+        buffer.data = (uint8_t*)mem_alloc_(buffer.size);
+    }
+    if ((buffer.data == 0) || ((uint32_t)total_size * 4 != buffer.size)) {
+        ESP_LOGW(TAG, "LvglDashboard::set_pack_chunk_: %d: no buffer: %d / %d", stream, offset, total_size);
+        return 0;
+    }
+    memcpy(&buffer.data[offset * 4], data, size * 4);
+    return offset + size == total_size? &buffer: 0;
+}
+
+void LvglDashboard::free_pack_(int stream) {
+    if (auto search = this->uploads_.find(stream); search != this->uploads_.end()) {
+        if (search->second.data != 0) mem_free_(search->second.data);
+        this->uploads_.erase(search);
+    }
+}
+
+// Many glyphs of one size in a single blob
+void LvglDashboard::service_set_glyph_pack(int32_t* data, int size, int offset, int total_size) {
+    auto* pack = this->set_pack_chunk_(UPLOAD_GLYPH_PACK, data, size, offset, total_size);
+    if (pack == 0) return;
+    uint32_t added = icons_->add_glyph_pack(pack->data, pack->size);
+    ESP_LOGD(TAG, "LvglDashboard::service_set_glyph_pack: %u bytes, %u glyphs", pack->size, added);
+    this->free_pack_(UPLOAD_GLYPH_PACK);
+}
+
+// Labels in font measured their text without the new glyphs, lv_label_set_text(NULL) lays them out again
+static void refresh_labels_(lv_obj_t* obj, const lv_font_t* font) {
+    if (lv_obj_check_type(obj, &lv_label_class) && (lv_obj_get_style_text_font(obj, LV_PART_MAIN) == font)) {
+        lv_label_set_text(obj, NULL);
+    }
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        refresh_labels_(lv_obj_get_child(obj, i), font);
+    }
+}
+
+// Header: glyph count (2), reserved (2), followed by the glyph records
+void LvglDashboard::service_set_text_glyphs(int font, int32_t* data, int size, int offset, int total_size) {
+    if ((font < 0) || (font >= this->text_fonts_.size())) {
+        ESP_LOGW(TAG, "LvglDashboard::service_set_text_glyphs: unknown font: %d", font);
+        return;
+    }
+    auto* pack = this->set_pack_chunk_(font, data, size, offset, total_size);
+    if (pack == 0) return;
+    if (pack->size >= 4) {
+        uint32_t count = read_le_(pack->data, 2);
+        uint32_t added = this->text_fonts_[font]->add_glyphs(pack->data + 4, pack->size - 4, count);
+        ESP_LOGD(TAG, "LvglDashboard::service_set_text_glyphs: %d: %u bytes, %u glyphs", font, pack->size, added);
+        if (added > 0) {
+            // Only labels using this font, on every screen and the top layer
+            lv_disp_t* disp = this->root_->get_disp();
+            const lv_font_t* primary = this->text_fonts_[font]->get_primary();
+            for (uint32_t i = 0; i < disp->screen_cnt; i++) refresh_labels_(disp->screens[i], primary);
+            refresh_labels_(lv_disp_get_layer_top(disp), primary);
+        }
+    }
+    this->free_pack_(font);
+}
+
+static const std::string EVENT_KEY_FONT = "font";
+static const std::string EVENT_KEY_HEIGHT = "height";
+static const std::string EVENT_KEY_BASE = "base";
+static const std::string EVENT_KEY_CODES = "codes";
+
+void LvglDashboard::request_text_glyphs_() {
+    std::vector<uint32_t> codes;
+    for (auto* font : this->text_fonts_) {
+        if (!font->take_missing(codes)) continue;
+        std::string value;
+        for (auto code : codes) {
+            if (!value.empty()) value += ",";
+            value += std::to_string(code);
+        }
+        ESP_LOGD(TAG, "LvglDashboard::request_text_glyphs_: %d: %s", font->get_index(), value.c_str());
+        const lv_font_t* base = font->get_base();
+        int index = font->get_index();
+        this->send_event_("text_glyphs", [index, base, &value](esphome::api::HomeassistantActionRequest* resp) {
+            esphome::api::HomeassistantServiceMap entry_;
+            entry_.set_key(esphome::StringRef(EVENT_KEY_FONT));
+            entry_.value = std::to_string(index);
+            resp->data.push_back(entry_);
+
+            // The integration picks the size of its font by these metrics
+            esphome::api::HomeassistantServiceMap entry__;
+            entry__.set_key(esphome::StringRef(EVENT_KEY_HEIGHT));
+            entry__.value = std::to_string(base->line_height);
+            resp->data.push_back(entry__);
+
+            esphome::api::HomeassistantServiceMap entry___;
+            entry___.set_key(esphome::StringRef(EVENT_KEY_BASE));
+            entry___.value = std::to_string(base->base_line);
+            resp->data.push_back(entry___);
+
+            esphome::api::HomeassistantServiceMap entry____;
+            entry____.set_key(esphome::StringRef(EVENT_KEY_CODES));
+            entry____.value = value;
+            resp->data.push_back(entry____);
+        });
+    }
+}
+
+void LvglDashboard::add_text_font_(esphome::lvgl::FontEngine* font) {
+    this->text_fonts_.push_back(new TextFont(this->text_fonts_.size(), font->get_lv_font()));
+}
+
+// Font for labels: the compiled font with its text glyph fallback
+const lv_font_t* LvglDashboard::get_text_font_(esphome::lvgl::FontEngine* font, const lv_font_t* def_font) {
+    if (font == 0) return def_font;
+    for (auto* text_font : this->text_fonts_) {
+        if (text_font->get_base() == font->get_lv_font()) return text_font->get_primary();
+    }
+    return font->get_lv_font();
+}
+
 void LvglDashboard::send_event(int page, int item, std::string type) {
     this->send_event_(type, [&page, &item, this] (esphome::api::HomeassistantActionRequest* resp) {
         if (page != -1) {
@@ -1780,7 +3488,49 @@ void LvglDashboard::on_item_event(int page, int item, int event) {
 }
 
 void LvglDashboard::on_data_request(int page, int item) {
-    this->send_event(page, item, "data_request");
+    this->send_event_("data_request", [&page, &item, this] (esphome::api::HomeassistantActionRequest* resp) {
+        esphome::api::HomeassistantServiceMap entry_;
+        entry_.set_key(esphome::StringRef(EVENT_KEY_PAGE));
+        entry_.value = std::to_string(page);
+        resp->data.push_back(entry_);
+
+        esphome::api::HomeassistantServiceMap entry__;
+        entry__.set_key(esphome::StringRef(EVENT_KEY_ITEM));
+        entry__.value = std::to_string(item);
+        resp->data.push_back(entry__);
+
+        if (this->little_endian_) {
+            esphome::api::HomeassistantServiceMap entry_;
+            entry_.set_key(esphome::StringRef(EVENT_KEY_LE));
+            entry_.value = "1";
+            resp->data.push_back(entry_);
+        }
+
+        // Largest decoded chunk the device takes per set_data_b64 call
+        esphome::api::HomeassistantServiceMap entry___;
+        entry___.set_key(esphome::StringRef(EVENT_KEY_CHUNK));
+        entry___.value = std::to_string(LVD_DATA_CHUNK);
+        resp->data.push_back(entry___);
+
+        #ifdef USE_LVD_JPEG
+        esphome::api::HomeassistantServiceMap entry____;
+        entry____.set_key(esphome::StringRef(EVENT_KEY_JPEG));
+        entry____.value = "1";
+        resp->data.push_back(entry____);
+        #endif
+
+        // Frame still shown, the integration can send set_data_rect patches against it
+        uint32_t frame = 0;
+        this->for_each_item([&frame](int, DashboardPage*, int, DashboardItem* item_obj) {
+            frame = item_obj->get_frame_hash();
+        }, page, item);
+        if (frame != 0) {
+            esphome::api::HomeassistantServiceMap entry_____;
+            entry_____.set_key(esphome::StringRef(EVENT_KEY_FRAME));
+            entry_____.value = std::to_string(frame);
+            resp->data.push_back(entry_____);
+        }
+    });
 }
 
 void LvglDashboard::on_tap_event(lv_event_code_t code, lv_event_t* event) {
@@ -1812,7 +3562,7 @@ void LvglDashboard::service_show_page(int page) {
     this->send_more_page_event(false);
 }
 
-void LvglDashboard::service_set_button(int index, std::string json_value) {
+void LvglDashboard::service_set_button(int index, const std::string &json_value) {
     json_parse_(json_value, [this, &index](JsonObject obj) {
         if ((index >= 0) && (index < this->button_objs_.size())) {
             this->button_objs_[index]->set_value(obj);
@@ -1847,7 +3597,7 @@ void LvglDashboard::service_hide_more() {
     this->hide_more_page();
 }
 
-void LvglDashboard::service_show_more(std::string json_value) {
+void LvglDashboard::service_show_more(const std::string &json_value) {
     json_parse_(json_value, [this](JsonObject obj) {
         this->show_more_page(obj);
     });
@@ -1857,7 +3607,15 @@ void LvglDashboard::service_set_data_more(int32_t* data, int size, int offset, i
     this->more_info_page_->set_data(data, size, offset, total_size);
 }
 
-void LvglDashboard::service_play_rtttl(std::string song) {
+void LvglDashboard::service_set_data_more_b64(const std::string &data, int offset, int total_size) {
+    this->more_info_page_->set_data_b64(data, offset, total_size);
+}
+
+void LvglDashboard::service_set_data_more_jpeg(const std::string &data, int offset, int total_size) {
+    this->more_info_page_->set_data_jpeg(data, offset, total_size, this->little_endian_);
+}
+
+void LvglDashboard::service_play_rtttl(const std::string &song) {
     if (this->rtttl_ != 0) {
         ESP_LOGD(TAG, "Rtttl play: %s", song.c_str());
         this->rtttl_->play(song);
@@ -1979,7 +3737,8 @@ bool MoreInfoPage::setup(lv_obj_t* parent, JsonObject data) {
             this->image_.header.always_zero = 0;
             this->image_.header.w = item["width"];
             this->image_.header.h = item["height"];
-            this->image_.header.cf = LV_IMG_CF_TRUE_COLOR;
+            this->image_.header.cf = image_cf_(item["cf"]);
+            image_tint_(this->image_cmp_, this->image_.header.cf);
             if (this->data_request_listener_ != 0)
                 this->data_request_listener_(this->entity_id_, item["id"]);
             if (!show_immediate) this->immediate_display_ = false;
@@ -2018,13 +3777,28 @@ void MoreInfoPage::on_tap_event(lv_event_code_t code, lv_event_t* event) {
 
 void MoreInfoPage::set_data(int32_t* data, int size, int offset, int total_size) {
     if (this->image_cmp_ == 0) return;
-    if (this->set_data_(data, size, offset, total_size) && (this->image_cmp_ != 0)) {
-        this->image_.data_size = this->data_size_;
-        this->image_.data = (unsigned char*)this->data_;
-        lv_img_set_src(this->image_cmp_, &this->image_);
-        if (!this->immediate_display_ && (this->load_finished_listener_ != 0))
-            this->load_finished_listener_();
-    }
+    if (this->set_data_(data, size, offset, total_size)) this->data_loaded();
+}
+
+void MoreInfoPage::set_data_b64(const std::string &data, int offset, int total_size) {
+    if (this->image_cmp_ == 0) return;
+    if (this->set_data_b64_(data, offset, total_size)) this->data_loaded();
+}
+
+void MoreInfoPage::set_data_jpeg(const std::string &data, int offset, int total_size, bool little_endian) {
+    if (this->image_cmp_ == 0) return;
+    if (this->set_src_b64_(data, offset, total_size) && this->decode_jpeg_(little_endian, &this->image_.header)) this->data_loaded();
+}
+
+void MoreInfoPage::data_loaded() {
+    if (!image_complete_(this->image_.header, this->back_size_)) return;
+    this->swap_data_();
+    this->image_.data_size = this->data_size_;
+    this->image_.data = (unsigned char*)this->data_;
+    lv_img_cache_invalidate_src(&this->image_);
+    lv_img_set_src(this->image_cmp_, &this->image_);
+    if (!this->immediate_display_ && (this->load_finished_listener_ != 0))
+        this->load_finished_listener_();
 }
 
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <new>
 
 #include "esphome/core/component.h"
 #include "esphome/core/application.h"
@@ -15,6 +16,9 @@
 #ifdef USE_BINARY_SENSOR
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #endif
+#ifdef USE_LVD_JPEG
+#include <JPEGDEC.h>
+#endif
 namespace esphome {
 namespace lvgl_dashboard {
 
@@ -102,6 +106,45 @@ class DashboardComponent : public esphome::Component, public esphome::binary_sen
 #ifndef LVD_TILE_BADGE_RADIUS
     #define LVD_TILE_BADGE_RADIUS 7
 #endif
+#ifndef LVD_MAX_GRID
+    #define LVD_MAX_GRID 24
+#endif
+#ifndef LVD_MAX_ITEMS
+    #define LVD_MAX_ITEMS 256
+#endif
+#ifndef LVD_PAGE_ARENA_BLOCK
+    #define LVD_PAGE_ARENA_BLOCK 4096
+#endif
+#ifndef LVD_GLYPH_CACHE_ENTRIES
+    #define LVD_GLYPH_CACHE_ENTRIES 32
+#endif
+#ifndef LVD_GLYPH_CACHE_BYTES
+    #define LVD_GLYPH_CACHE_BYTES 16384
+#endif
+#ifndef LVD_DATA_CHUNK
+    #define LVD_DATA_CHUNK 8192
+#endif
+#ifndef LVD_BUFFER_POOL_BYTES
+    #define LVD_BUFFER_POOL_BYTES 262144
+#endif
+#ifndef LVD_BUFFER_POOL_MIN_CLASS
+    #define LVD_BUFFER_POOL_MIN_CLASS 1024
+#endif
+#ifndef LVD_TEXT_GLYPH_BYTES
+    #define LVD_TEXT_GLYPH_BYTES 32768
+#endif
+#ifndef LVD_TEXT_GLYPH_REQUEST
+    #define LVD_TEXT_GLYPH_REQUEST 32
+#endif
+#ifndef LVD_OUTLINE_BPP
+    #define LVD_OUTLINE_BPP 4
+#endif
+#ifndef LVD_OUTLINE_SAMPLES
+    #define LVD_OUTLINE_SAMPLES 4
+#endif
+#ifndef LVD_OUTLINE_CURVE_STEPS
+    #define LVD_OUTLINE_CURVE_STEPS 6
+#endif
 
 typedef struct {
     lv_coord_t width;
@@ -128,24 +171,32 @@ typedef struct {
     lv_coord_t tile_badge_radius;
 } ThemeDef;
 
+enum ItemLayout : uint8_t {
+    ITEM_NONE = 0,
+    ITEM_LOCAL,
+    ITEM_BUTTON,
+    ITEM_SENSOR,
+    ITEM_PICTURE,
+    ITEM_LAYOUT,
+    ITEM_TILE,
+    ITEM_HEADING,
+};
+
 typedef struct {
-    std::string id;
-    int col;
-    int row;
-    int cols;
-    int rows;
-    std::string icon;
-    std::string label;
-    std::string layout;
+    uint8_t col;
+    uint8_t row;
+    uint8_t cols;
+    uint8_t rows;
+    ItemLayout layout;
+    const char* icon; // Static text of the local item
+    const char* label;
 } ItemDef;
 
 typedef struct {
-    std::string title;
-    int cols;
-    int rows;
+    uint8_t cols;
+    uint8_t rows;
     bool vertical;
-    ItemDef items[32];
-    int items_size;
+    std::vector<ItemDef> items;
 } PageDef;
 
 class ButtonComponentWrapper {
@@ -187,6 +238,12 @@ typedef struct {
     LvglItemEventListener* listener;
 } ItemEventListenerDef;
 
+// Blob collected from int[] chunks
+typedef struct {
+    uint8_t* data;
+    uint32_t size;
+} UploadBuffer;
+
 typedef struct {
     int index;
     DashboardButtonListener* listener;
@@ -197,21 +254,105 @@ typedef struct {
     LvglPageEventListener* listener;
 } LvglPageEventListenerDef;
 
+// Packed glyph box, the bitmap lives in the font slab in its transfer format, outlines already rasterized
+typedef struct {
+    uint32_t bitmap;
+    uint16_t size;
+    uint8_t fmt;
+    uint8_t ofs_x;
+    uint8_t ofs_y;
+    uint8_t box_w;
+    uint8_t box_h;
+} GlyphDsc;
+
+// Glyph of an icon name, hash identifies the content sent by the integration
+typedef struct {
+    uint32_t code;
+    uint32_t hash;
+} GlyphRef;
+
+// Icon rasterized by codegen, raw 1bpp bitmap at offset bitmap of the table's flash blob
+typedef struct {
+    const char* name;
+    uint32_t bitmap;
+    uint8_t ofs_x;
+    uint8_t ofs_y;
+    uint8_t box_w;
+    uint8_t box_h;
+} StaticGlyph;
+
+// Sorted by name
+typedef struct {
+    const StaticGlyph* glyphs;
+    uint32_t count;
+    const uint8_t* bitmaps;
+} StaticGlyphs;
+
+typedef struct {
+    const void* font;
+    uint32_t code;
+    uint8_t* data;
+    uint32_t size;
+    uint32_t used;
+} GlyphCacheEntry;
+
+// Bounded LRU of decoded bitmaps for compressed glyphs
+class GlyphCache {
+    protected:
+        GlyphCacheEntry entries_[LVD_GLYPH_CACHE_ENTRIES] {};
+        uint32_t clock_ = 0;
+        uint32_t bytes_ = 0;
+        uint32_t hits_ = 0;
+        uint32_t misses_ = 0;
+        uint32_t evictions_ = 0;
+        uint8_t* scratch_ = 0; // Glyphs that do not fit the cache, decoded again on every draw
+        uint32_t scratch_size_ = 0;
+
+        void evict_(GlyphCacheEntry* entry);
+
+    public:
+        uint8_t* find(const void* font, uint32_t code);
+        uint8_t* insert(const void* font, uint32_t code, uint32_t size);
+        uint8_t* scratch(uint32_t size);
+        void drop(const void* font);
+
+        uint32_t get_hits() { return this->hits_; }
+        uint32_t get_misses() { return this->misses_; }
+        uint32_t get_evictions() { return this->evictions_; }
+        uint32_t get_bytes() { return this->bytes_; }
+};
+
 class MdiFont {
     protected:
         int size_;
         lv_font_t lv_font_ {};
-        std::map<uint32_t, uint8_t*> glyphs_ = {};
-        std::map<std::string, uint32_t> codes_ = {};
+        std::vector<GlyphDsc> glyphs_ = {}; // Indexed by code - first_code_
+        uint32_t first_code_ = 0; // Moves on with every destroy(), labels still showing old codes draw nothing
+        uint8_t* slab_ = 0;
+        uint32_t slab_size_ = 0;
+        uint32_t slab_used_ = 0;
+        std::map<std::string, GlyphRef> codes_ = {};
+        StaticGlyphs static_ {};
+
+        inline const GlyphDsc* find_glyph_(uint32_t unicode_letter);
+        inline const StaticGlyph* find_static_(uint32_t unicode_letter);
+        uint32_t find_static_(const std::string &icon, uint32_t hash);
+        uint8_t* reserve_bitmap_(uint32_t size);
+        uint32_t add_glyph_(const std::string &icon, uint32_t hash, const uint8_t* header, uint32_t size);
 
     public:
         MdiFont(int size);
         const lv_font_t *get_lv_font() { return &this->lv_font_; }
+        void set_static(const StaticGlyphs &glyphs) { this->static_ = glyphs; }
 
         bool create_glyph_dsc(uint32_t unicode_letter, lv_font_glyph_dsc_t *dsc);
         const uint8_t* get_glyph_data(uint32_t unicode_letter);
 
-        uint32_t add_glyph(std::string icon, std::string b64_data);
+        uint32_t add_glyph(std::string icon, uint32_t hash, std::string b64_data);
+        uint32_t add_glyphs(const uint8_t* data, uint32_t len, uint32_t count);
+        uint32_t find_glyph(const std::string &icon, uint32_t hash);
+        uint32_t digest(uint32_t* count);
+        void append_records(std::string &result);
         void destroy();
 
 };
@@ -219,25 +360,124 @@ class MdiFont {
 class MdiFontCapable {
     protected:
         std::map<int, MdiFont*> fonts_ {};
+        std::map<int, StaticGlyphs> static_ {};
+        uint32_t misses_ = 0;
 
         MdiFont* get_font(int size);
 
     public:
-        void set_icon(lv_obj_t* obj, JsonObject icon_data, bool hide_default = false);
+        bool set_icon(lv_obj_t* obj, JsonObject icon_data, bool hide_default = false);
+        uint32_t add_glyph_pack(const uint8_t* data, uint32_t len);
+        void add_static(int size, const StaticGlyph* glyphs, uint32_t count, const uint8_t* bitmaps);
         void clear();
+        uint32_t digest(uint32_t* count);
+        std::string get_static_names();
+        std::string get_records();
+        uint32_t get_misses() { return this->misses_; }
+};
+
+typedef struct {
+    uint8_t* bitmap;
+    uint32_t used;
+    uint8_t adv_w;
+    int8_t ofs_x;
+    int8_t ofs_y;
+    uint8_t box_w;
+    uint8_t box_h;
+    uint8_t bpp;
+} TextGlyph;
+
+// Fallback of a compiled text font: codepoints outside its glyph set are requested from the integration
+// and kept in a bounded LRU store
+class TextFont {
+    protected:
+        int index_;
+        const lv_font_t* base_;
+        lv_font_t lv_font_ {};
+        lv_font_t primary_ {}; // Copy of the base font, falls back to lv_font_
+        std::map<uint32_t, TextGlyph> glyphs_ {};
+        std::set<uint32_t> requested_ {};
+        std::vector<uint32_t> missing_ {};
+        uint32_t bytes_ = 0;
+        uint32_t clock_ = 0;
+
+        bool evict_(uint32_t size);
+
+    public:
+        TextFont(int index, const lv_font_t* base);
+        const lv_font_t* get_lv_font() { return &this->lv_font_; }
+        const lv_font_t* get_base() { return this->base_; }
+        const lv_font_t* get_primary() { return &this->primary_; }
+        int get_index() { return this->index_; }
+
+        bool create_glyph_dsc(uint32_t unicode_letter, lv_font_glyph_dsc_t *dsc);
+        const uint8_t* get_glyph_data(uint32_t unicode_letter);
+        uint32_t add_glyphs(const uint8_t* data, uint32_t len, uint32_t count);
+        bool take_missing(std::vector<uint32_t> &codes);
+        void retry();
+        void clear();
+};
+
+// Released image buffers by size class, kept up to LVD_BUFFER_POOL_BYTES for the next image of the class
+class BufferPool {
+    protected:
+        std::map<uint32_t, std::vector<uint8_t*>> free_ {};
+        uint32_t held_ = 0;
+        uint32_t hits_ = 0;
+        uint32_t misses_ = 0;
+
+    public:
+        static uint32_t size_class(uint32_t size);
+
+        uint8_t* acquire(uint32_t size);
+        void release(uint8_t* data, uint32_t size);
+        void trim(uint32_t bytes);
+
+        uint32_t get_held() { return this->held_; }
+        uint32_t get_hits() { return this->hits_; }
+        uint32_t get_misses() { return this->misses_; }
 };
 
 class WithDataBuffer {
     protected:
+        // Front buffer is the shown frame, chunks land in the back buffer until it is swapped in
         uint8_t* data_ = 0;
         uint32_t data_size_ = 0;
+        uint8_t* back_ = 0;
+        uint32_t back_size_ = 0;
+        // Compressed source, decoded into data_ once complete
+        uint8_t* src_ = 0;
+        uint32_t src_size_ = 0;
 
         uint8_t* create_data_(uint32_t size);
         bool set_data_(int32_t* data, int size, int offset, int total_size);
+        bool set_data_b64_(const std::string &data, int offset, int total_size);
+        bool set_src_b64_(const std::string &data, int offset, int total_size);
+        bool decode_jpeg_(bool little_endian, lv_img_header_t* header);
+        void swap_data_();
         void destroy_();
 
 };
 
+// Bump allocator owning the items of a page, released at once with reset()
+class PageArena {
+    protected:
+        std::vector<uint8_t*> blocks_ {};
+        size_t used_ = 0;
+
+    public:
+        ~PageArena();
+
+        void* allocate(size_t size, size_t align);
+        void reset();
+
+        template <typename T>
+        T* create() {
+            void* ptr = this->allocate(sizeof(T), alignof(T));
+            return ptr != 0? new (ptr) T(): 0;
+        }
+};
+
 static lv_style_t item_style_normal_;
 static lv_style_t item_style_pressed_;
 class DashboardItem {
@@ -256,7 +496,7 @@ class DashboardItem {
         void set_bg_color(lv_obj_t* obj, JsonObject data, bool def_color);
         void set_text_color(lv_obj_t* obj, JsonObject data);
         void set_font(lv_obj_t* obj, JsonObject data);
-        lv_color_t parse_color(std::string color, lv_color_t def_color);
+        lv_color_t parse_color(JsonVariant color, lv_color_t def_color);
 
         void request_data();
 
@@ -270,6 +510,11 @@ class DashboardItem {
 
         virtual void set_value(JsonObject data) {}
         virtual void set_data(int32_t* data, int size, int offset, int total_size) {}
+        virtual void set_data_b64(const std::string &data, int offset, int total_size) {}
+        virtual void set_data_jpeg(const std::string &data, int offset, int total_size, bool little_endian) {}
+        virtual void set_data_rect(const std::string &data) {}
+        // Hash of the frame the item shows, 0 when there is none to patch
+        virtual uint32_t get_frame_hash() { return 0; }
 
         void loop();
         void on_tap_event(lv_event_code_t code, lv_event_t* event);
@@ -281,7 +526,10 @@ class DashboardItem {
             return result;
         }
 
-        static DashboardItem* new_instance(ItemDef* def);
+        virtual ~DashboardItem() {}
+
+        static DashboardItem* new_instance(ItemDef* def, PageArena* arena);
+        static ItemLayout parse_layout(const std::string &layout);
 };
 
 class LocalItem : public DashboardItem {
@@ -295,14 +543,35 @@ class ButtonItem : public DashboardItem {
         void set_value(JsonObject data) override;
 };
 
+typedef struct {
+    int col;
+    int row;
+    std::string shape;
+
+    int cols;
+    int rows;
+    uint16_t radius;
+    std::string style;
+    std::string content;
+    bool icon;
+
+    lv_obj_t* shape_obj;
+    lv_obj_t* label;
+} LayoutCell;
+
 class LayoutItem : public DashboardItem {
     protected:
-        lv_coord_t row_dsc_[6] = {
-            LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-            LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
-        lv_coord_t col_dsc_[6] = {
-            LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-            LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
+        // Sized to the tracks of the payload, up to LVD_MAX_GRID
+        std::vector<lv_coord_t> row_dsc_ {};
+        std::vector<lv_coord_t> col_dsc_ {};
+
+        std::vector<LayoutCell> cells_ {};
+        std::string style_ = "";
+        bool grid_set_ = false;
+
+        bool set_grid_dsc(std::vector<lv_coord_t> &dsc, JsonArray values);
+        lv_obj_t* create_shape(std::string shape);
+        void update_cell(LayoutCell* cell, JsonObject item, int cols, int rows);
     public:
         void setup(lv_obj_t* root) override;
         void set_value(JsonObject data) override;
@@ -330,6 +599,20 @@ class TileItem : public DashboardItem {
             LV_GRID_TEMPLATE_LAST };
 
         lv_obj_t* tile_ = nullptr;
+        lv_obj_t* toggle_ = nullptr;
+        lv_obj_t* icon_ = nullptr;
+        lv_obj_t* badge_ = nullptr;
+        lv_obj_t* name_ = nullptr;
+        lv_obj_t* value_ = nullptr;
+
+        int vertical_ = -1;
+        std::string features_ = "";
+        std::string icon_key_ = "";
+        std::string style_ = "";
+        std::string badge_color_ = "";
+
+        void set_variant(bool vertical, std::string features);
+        void set_label(lv_obj_t* obj, std::string text);
     public:
         void setup(lv_obj_t* root) override;
         void set_value(JsonObject data) override;
@@ -351,15 +634,26 @@ class HeaderItem : public DashboardItem {
 class ImageItem : public DashboardItem, public WithDataBuffer {
     protected:
         lv_img_dsc_t image_{};
+        lv_img_header_t header_{}; // Of the frame being received
         lv_obj_t* lv_img_ = 0;
         bool data_pending_ = false;
+        uint32_t frame_hash_ = 0;
+
+        bool has_frame_();
+        void update_frame_hash_();
+        void invalidate_(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
     public:
         void setup(lv_obj_t* root) override;
         void set_value(JsonObject data) override;
         void set_data(int32_t* data, int size, int offset, int total_size) override;
+        void set_data_b64(const std::string &data, int offset, int total_size) override;
+        void set_data_jpeg(const std::string &data, int offset, int total_size, bool little_endian) override;
+        void set_data_rect(const std::string &data) override;
+        uint32_t get_frame_hash() override;
         void destroy() override;
 
         void draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint16_t color);
+        void draw(uint32_t x, uint32_t y, uint32_t w, uint32_t h, const uint8_t* pixels);
         void show();
         bool show(bool visible) override;
 };
@@ -403,9 +697,16 @@ class DashboardButton {
 
 static lv_style_t page_style_;
 static lv_style_t sub_page_style_;
+// Latest set_value payload of an item
+typedef struct {
+    std::string data;
+    bool msgpack;
+    bool applied;
+} ValueUpdate;
+
 class DashboardPage {
     protected:
-        PageDef* def_ = 0;
+        PageDef def_;
         lv_obj_t* page_ = 0;
         lv_obj_t* root_ = 0; // Dashboard
         lv_obj_t* close_btn_ = 0;
@@ -413,29 +714,36 @@ class DashboardPage {
         LvglPageEventListenerDef listener_{.index = 0, .listener = 0};
 
         std::vector<DashboardItem*> items_ = {};
+        PageArena arena_ {};
+        std::map<int, ValueUpdate> values_ {}; // Latest values, kept to (re)build the page when shown
+        uint32_t shown_ = 0;
 
         lv_coord_t page_row_dsc_[2] = {LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
         lv_coord_t page_col_dsc_[3] = {LV_GRID_CONTENT, LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
 
-        lv_coord_t row_dsc_[13] = {LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-                                 LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-                                 LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
-        lv_coord_t col_dsc_[13] = {LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-                                 LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 
-                                 LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
+        std::vector<lv_coord_t> row_dsc_ {};
+        std::vector<lv_coord_t> col_dsc_ {};
 
         lv_obj_t* create_page(lv_obj_t* root, bool sub_page);
 
     public:
-        DashboardPage(PageDef* def) { this->def_ = def; }
+        DashboardPage(PageDef &&def): def_(std::move(def)) {}
         static void init(lv_obj_t* obj, bool init);
         void setup(lv_obj_t* parent, int page, LvglItemEventListener *listener, LvglPageEventListener *page_listener);
         void destroy(int page);
+        void evict(int page);
         void show(int page, bool visible);
         lv_obj_t* get_lv_obj() { return this->root_; }
+        bool is_built() { return this->root_ != 0; }
+        uint32_t get_shown() { return this->shown_; }
+        void set_shown(uint32_t shown) { this->shown_ = shown; }
 
         void for_each_item(std::function<void(int, DashboardItem*)> &&fn, int item);
         void on_tap_event(lv_event_code_t code, lv_event_t* event);
+
+        bool defer_value(int item, const char* data, size_t size, bool msgpack);
+        void remember_value(int item, const char* data, size_t size, bool msgpack);
+        void take_pending(std::function<void(int, ValueUpdate&)> &&fn);
 };
 
 static lv_style_t more_page_base_;
@@ -482,6 +790,9 @@ class MoreInfoPage : public WithDataBuffer {
         void on_tap_event(lv_event_code_t code, lv_event_t* event);
 
         void set_data(int32_t* data, int size, int offset, int total_size);
+        void set_data_b64(const std::string &data, int offset, int total_size);
+        void set_data_jpeg(const std::string &data, int offset, int total_size, bool little_endian);
+        void data_loaded();
 };
 
 static lv_style_t top_style_;
@@ -504,7 +815,6 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
 
         std::vector<DashboardPage*> page_objs_ = {};
         std::vector<DashboardButton*> button_objs_ = {};
-        PageDef pages_[16] {};
         
         lv_obj_t* page_ = 0;
         lv_theme_t* theme__;
@@ -530,6 +840,13 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
         esphome::lvgl::FontEngine* normal_font_ = 0;
         esphome::lvgl::FontEngine* large_font_ = 0;
         esphome::lvgl::FontEngine* small_font_ = 0;
+        std::vector<TextFont*> text_fonts_ {};
+
+        void add_text_font_(esphome::lvgl::FontEngine* font);
+        const lv_font_t* get_text_font_(esphome::lvgl::FontEngine* font, const lv_font_t* def_font);
+        void request_text_glyphs_();
+        UploadBuffer* set_pack_chunk_(int stream, int32_t* data, int size, int offset, int total_size);
+        void free_pack_(int stream);
 
         void show_page(int index);
 
@@ -550,18 +867,58 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
         void clear_pages();
         void clear();
 
+        int batch_depth_ = 0;
+        std::set<lv_obj_t*> batch_objs_ {};
+
+        void begin_batch_();
+        void end_batch_();
+        void apply_value_(int page, int item, JsonObject obj);
+        void apply_values_(JsonObject obj);
+        bool parse_page_(JsonObject obj, PageDef &page);
+
+        std::map<uint32_t, ValueUpdate> updates_ {};
+        uint32_t update_budget_ = 10;
+        uint32_t updates_last_ = 0;
+        uint32_t updates_next_ = 0; // Key the next drain starts from
+        uint32_t updates_coalesced_ = 0;
+        uint32_t updates_dropped_ = 0;
+        uint32_t updates_carried_ = 0; // Left for the next drain when the budget ran out
+        uint32_t updates_logged_ = 0;
+        uint32_t glyphs_logged_ = 0;
+        uint32_t parses_logged_ = 0;
+        // Chunked uploads by stream: the glyph pack or the index of a text font
+        std::map<int, UploadBuffer> uploads_ {};
+
+        void queue_value_(int page, int item, const char* data, size_t size, bool msgpack);
+        void drain_values_();
+        void drop_values_();
+        bool page_hidden_(int page);
+        bool defer_value_(int page, int item, const char* data, size_t size, bool msgpack);
+        void apply_pending_(int page);
+        void remember_value_(int page, int item, const char* data, size_t size, bool msgpack);
+
+        uint32_t pages_shown_ = 0;
+        int max_pages_ = 0;
+        uint32_t min_free_heap_ = 0;
+
+        void evict_pages_();
+
     public:
 
         static lv_obj_t* create_root_btn(lv_obj_t* root, std::string icon);
 
         void set_mdi_fonts(esphome::font::Font* small_font, esphome::font::Font* large_font);
+        void add_static_icons(int size, const StaticGlyph* glyphs, uint32_t count, const uint8_t* bitmaps);
         void set_fonts(esphome::font::Font* normal_font, esphome::font::Font* large_font, esphome::font::Font* small_font) {
             this->normal_font_ = new esphome::lvgl::FontEngine(normal_font);
+            this->add_text_font_(this->normal_font_);
             if (large_font != 0) {
                 this->large_font_ = new esphome::lvgl::FontEngine(large_font);
+                this->add_text_font_(this->large_font_);
             }
             if (small_font != 0) {
                 this->small_font_ = new esphome::lvgl::FontEngine(small_font);
+                this->add_text_font_(this->small_font_);
             }
         }
         void init(lv_obj_t* obj, bool init);
@@ -576,8 +933,14 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
         void set_backlight(esphome::switch_::Switch* backlight) { this->backlight_ = backlight; }
         void set_rtttl(esphome::rtttl::Rtttl* rtttl) { this->rtttl_ = rtttl; }
         void set_dashboard_reset_timeout(uint16_t timeout) { this->dashboard_timeout_ = timeout; }
+        void set_update_budget(uint32_t budget) { this->update_budget_ = budget; }
+        void set_page_cache(int max_pages, uint32_t min_free_heap) {
+            this->max_pages_ = max_pages;
+            this->min_free_heap_ = min_free_heap;
+        }
         void add_component(esphome::Component* component) { this->components_.push_back(component); }
         void setup() override;
+        void loop() override;
         void update() override;
 
         void add_button_component(std::string type, esphome::EntityBase* component);
@@ -593,8 +956,8 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
         void for_each_item(std::function<void(int, DashboardPage*, int, DashboardItem*)> &&fn, int page, int item);
 
         void set_buttons();
-        void add_page(PageDef* page, int index);
-        void set_pages(PageDef* pages, int size);
+        void add_page(PageDef &&page, int index);
+        void set_pages(std::vector<PageDef> &&pages);
 
         void on_event(lv_event_t* event);
         void on_tap_event(lv_event_code_t code, lv_event_t* event);
@@ -604,17 +967,28 @@ class LvglDashboard : virtual public LvglItemEventListener, virtual public LvglP
 
         void update_connection_state();
 
-        void service_set_pages(std::vector<std::string> pages, int page);
-        void service_add_page(std::string page, bool reset);
-        void service_set_value(int page, int item, std::string value);
+        void service_set_pages(const std::vector<std::string> &pages, int page);
+        void service_add_page(const std::string &page, bool reset);
+        void service_set_value(int page, int item, const std::string &value);
+        void service_set_value_bin(int page, int item, int32_t* data, int size, int total_size);
+        void service_set_values(const std::string &json_value);
+        void service_set_values_bin(int32_t* data, int size, int total_size);
         void service_set_data(int page, int item, int32_t* data, int size, int offset, int total_size);
         void service_show_page(int page);
-        void service_set_button(int index, std::string json_value);
-        void service_show_more(std::string json_value);
+        void service_set_button(int index, const std::string &json_value);
+        void service_show_more(const std::string &json_value);
         void service_hide_more();
         void service_set_data_more(int32_t* data, int size, int offset, int total_size);
-        void service_play_rtttl(std::string song);
-        void service_set_theme(std::string json_value);
+        void service_set_data_b64(int page, int item, const std::string &data, int offset, int total_size);
+        void service_set_data_more_b64(const std::string &data, int offset, int total_size);
+        void service_set_data_jpeg(int page, int item, const std::string &data, int offset, int total_size);
+        void service_set_data_rect(int page, int item, const std::string &data);
+        void service_set_data_more_jpeg(const std::string &data, int offset, int total_size);
+        void service_play_rtttl(const std::string &song);
+        void service_sync_glyphs(bool reset);
+        void service_set_glyph_pack(int32_t* data, int size, int offset, int total_size);
+        void service_set_text_glyphs(int font, int32_t* data, int size, int offset, int total_size);
+        void service_set_theme(const std::string &json_value);
 };
 
 }
@@ -37,22 +37,34 @@ from .constants import (
 from .mdi_font.icon import icon_from_state
 
 from .mdi_font import GlyphProvider
-from .picture import bytes_to_565_ints, async_get_image_by_entity_id, bytes_to_scaled
+from .mdi_font.compress import pack_glyphs
+from .text_font import TextGlyphProvider
+from .picture import bytes_to_565_ints, bytes_to_565, bytes_to_size, bytes_to_jpeg, bytes_to_indexed, bytes_to_alpha, indexed_bpp, frame_delta, async_get_image_by_entity_id, bytes_to_scaled
+from .encoding import msgpack_encode, to_binary_value, bytes_to_ints, fnv1a32
 
+import asyncio
 import collections.abc
+import contextvars
 import logging
-import json, copy
+import json, copy, base64, functools
 from datetime import datetime
 
 _LOGGER = logging.getLogger(__name__)
 
 SET_DATA_BATCH = 500
+SET_VALUES_MAX_SIZE = 16384
+GLYPHS_SYNC_TIMEOUT = 5
 PICTURE_DEF_SCALE_ITEM = 60
 PICTURE_DEF_SCALE_MORE = 400
+PICTURE_DEF_COLORS = 16
 
 ICON_SMALL = 25
 ICON_LARGE = 55
 
+# Per send, sends for different state changes run concurrently in their own tasks
+_GLYPHS_PACK = contextvars.ContextVar("glyphs_pack", default=None)
+_GLYPHS_BYPASS = contextvars.ContextVar("glyphs_bypass", default=False)
+
 class Coordinator(DataUpdateCoordinator):
 
     def __init__(self, hass, entry):
@@ -74,6 +86,14 @@ class Coordinator(DataUpdateCoordinator):
         self._on_entity_state_handler = None
         self._on_event_handler = None
 
+        self._glyphs_sent = {}
+        self._glyphs_enabled = False
+        self._glyphs_static = set()
+        self._glyphs_future = None
+        self._glyphs_max_fmt = 1
+        self._text_glyphs = None
+        self._frames = {}
+
     async def _async_setup(self):
         self._mdi_font = GlyphProvider()
         await self.hass.async_add_executor_job(self._mdi_font.init)
@@ -172,16 +192,31 @@ class Coordinator(DataUpdateCoordinator):
             _LOGGER.exception(f"async_picture_from_state: error getting picture")
         return (None, None)
     
-    async def async_picture_from_state(self, entity_id: str | None, state, size: int, le: bool = False):
+    async def async_picture_from_state(self, entity_id: str | None, state, size: int, le: bool = False, raw: bool = False, jpeg: bool = False, fmt: dict | None = None):
         try:
             if entity_id:
                 if image_ := await self.async_picture_by_entity_id(entity_id):
-                    size, data = bytes_to_565_ints(image_.content, image_.content_type, size, le)
+                    convert = bytes_to_jpeg if jpeg else (bytes_to_565 if raw else bytes_to_565_ints)
+                    if fmt and fmt["cf"] == "a8":
+                        convert = bytes_to_alpha
+                    elif fmt:
+                        convert = functools.partial(bytes_to_indexed, colors=fmt["colors"])
+                    size, data = convert(image_.content, image_.content_type, size, le)
                     return (size, data)
         except:
             _LOGGER.exception(f"async_picture_from_state: error getting picture")
         return (None, None)
     
+    async def async_picture_size(self, entity_id: str | None, size: int) -> tuple | None:
+        """ Size the picture is sent with, without converting its pixels """
+        try:
+            if entity_id:
+                if image_ := await self.async_picture_by_entity_id(entity_id):
+                    return bytes_to_size(image_.content, image_.content_type, size)
+        except:
+            _LOGGER.exception(f"async_picture_size: error getting picture")
+        return None
+
     def color_from_state(self, state, item: dict) -> str:
         result = ""
         if col_ := self._g(item, "color", state=state):
@@ -198,8 +233,56 @@ class Coordinator(DataUpdateCoordinator):
     def state_by_entity_id(self, entity_id: str | None):
         return self.hass.states.get(entity_id) if entity_id else None
 
-    async def async_send_picture_data(self, service: str, entity_id: str, scale: int, le: bool, cb):
+    def _picture_format(self, item: dict) -> dict | None:
+        """ Palette or alpha only pixels for the picture, None for RGB565. Needs the base64 transport on the device """
+        format_ = self._g(item, "format", "true_color")
+        if format_ not in ("indexed", "alpha") or not self.has_device_service("set_data_b64"):
+            return None
+        if format_ == "alpha":
+            return {"cf": "a8"}
+        colors = max(2, min(256, int(self._g(item, "colors", PICTURE_DEF_COLORS))))
+        return {"cf": f"i{indexed_bpp(colors)}", "colors": colors}
+
+    async def async_send_picture_data(
+        self, service: str, entity_id: str, scale: int, le: bool, cb, chunk: int = 0, jpeg: bool = False, fmt: dict | None = None,
+        frame_key: tuple | None = None, frame: int = 0
+    ):
         state = self.state_by_entity_id(entity_id)
+        jpeg = jpeg and not fmt and self.has_device_service(f"{service}_jpeg")
+        suffix = "_jpeg" if jpeg else "_b64"
+        if chunk > 0 and self.has_device_service(f"{service}{suffix}"):
+            # Base64 chunks of the size the device asked for, decoded in place into the image buffer
+            # (JPEG is collected first and decoded by the device once complete)
+            size, data = await self.async_picture_from_state(entity_id, state, scale, le, raw=True, jpeg=jpeg, fmt=fmt)
+            if size and data and frame_key and (jpeg or fmt):
+                _LOGGER.debug(f"async_send_picture_data: {frame_key}: not patched, {'jpeg' if jpeg else fmt['cf']} frame")
+                self._frames.pop(frame_key, None)
+            elif size and data and frame_key:
+                # RGB565 frames are kept to patch only the changed rectangles when the device still shows the last one
+                previous = self._frames.get(frame_key)
+                self._frames[frame_key] = (size, data, fnv1a32(data))
+                if previous and not self.has_device_service(f"{service}_rect"):
+                    _LOGGER.debug(f"async_send_picture_data: {frame_key}: not patched, no {service}_rect service")
+                elif previous and (previous[0] != size or previous[2] != frame):
+                    _LOGGER.debug(f"async_send_picture_data: {frame_key}: not patched, device frame: {frame}, size: {previous[0]} -> {size}")
+                elif previous and (blobs := frame_delta(previous[1], data, size, chunk)) is not None:
+                    for blob in blobs:
+                        await self.async_call_device_service(f"{service}_rect", {
+                            "data": base64.standard_b64encode(blob).decode("ascii"), 
+                            **cb(),
+                        })
+                    return
+            if size and data:
+                for offset in range(0, len(data), chunk):
+                    await self.async_call_device_service(f"{service}{suffix}", {
+                        "data": base64.standard_b64encode(data[offset:(offset + chunk)]).decode("ascii"), 
+                        "offset": offset, "size": len(data),
+                        **cb(),
+                    })
+            return
+        if frame_key:
+            _LOGGER.debug(f"async_send_picture_data: {frame_key}: not patched, int[] transport")
+            self._frames.pop(frame_key, None)
         size, data = await self.async_picture_from_state(entity_id, state, scale, le)
         if size and data:
             offset = 0
@@ -259,7 +342,7 @@ class Coordinator(DataUpdateCoordinator):
             icon_size = int(self._g(item, "size", ICON_LARGE, state=state) * theme_scale)
             return {
                 "name": self._g(item, "name", self.name_from_state(entity_id, state), state=state),
-                "icon": self._mdi_font.get_icon_value(icon, icon_size),
+                "icon": self._icon_value(icon, icon_size),
                 "ctype": self._g(item, "ctype", "button"),
                 "col": self.color_from_state(state, item),
                 "font": self._to_font(item, state),
@@ -269,7 +352,7 @@ class Coordinator(DataUpdateCoordinator):
             icon_size = int(self._g(item, "size", ICON_SMALL, state=state))
             return {
                 "name": self._g(item, "name", self.name_from_state(entity_id, state), state=state),
-                "icon": self._mdi_font.get_icon_value(icon, icon_size),
+                "icon": self._icon_value(icon, icon_size),
                 "value": str(self._g(item, "value", state.state if state else "", state=state)),
                 "unit": self._g(item, "unit", state.attributes.get("unit_of_measurement", "") if state else ""),
                 "ctype": self._g(item, "ctype", "text"),
@@ -281,7 +364,7 @@ class Coordinator(DataUpdateCoordinator):
             icon_size = int(self._g(item, "size", ICON_SMALL, state=state))
             response = {
                 "name": self._g(item, "name", self.name_from_state(entity_id, state), state=state),
-                "icon": self._mdi_font.get_icon_value(icon, icon_size),
+                "icon": self._icon_value(icon, icon_size),
                 "value": str(self._g(item, "value", state.state if state else "", state=state)),
                 "col": self.color_from_state(state, item),
                 "v": self._g(item, "vertical", False),
@@ -298,13 +381,12 @@ class Coordinator(DataUpdateCoordinator):
             return {
                 "name": self._g(item, "heading", self.name_from_state(entity_id, state), state=state),
                 "large": self._g(item, "large", False),
-                "icon": self._mdi_font.get_icon_value(icon, icon_size),
+                "icon": self._icon_value(icon, icon_size),
             }
         if layout == "picture":
             scale = self._g(item, "scale", PICTURE_DEF_SCALE_ITEM, state=state)
-            size, data = await self.async_picture_from_state(entity_id, state, int(scale * theme_scale))
-            if size and data:
-                return {
+            if size := await self.async_picture_size(entity_id, int(scale * theme_scale)):
+                result = {
                     "ctype": self._g(item, "ctype", "button"),
                     "col": self.color_from_state(state, item),
                     "image": {
@@ -313,6 +395,9 @@ class Coordinator(DataUpdateCoordinator):
                         "uri": self.browser_image_url(entity_id, scale) if self.is_browser else None,
                     }
                 }
+                if not self.is_browser and (fmt := self._picture_format(item)):
+                    result["image"]["cf"] = fmt["cf"]
+                return result
         if layout == "layout":
             items = []
             ctype = self._g(item, "ctype", "button")
@@ -350,7 +435,7 @@ class Coordinator(DataUpdateCoordinator):
                     item__["label"] = self._g(item_, "label", state=state_)
                 else:
                     icon_size = self._g(item_, "size", ICON_SMALL, state=state_)
-                    item__["icon"] = self._mdi_font.get_icon_value(
+                    item__["icon"] = self._icon_value(
                         icon_from_state(self._g(item_, "icon", state=state_), state_), 
                         int(icon_size * theme_scale)
                     )
@@ -359,15 +444,92 @@ class Coordinator(DataUpdateCoordinator):
             return result
         return None
 
+    async def async_send_value(self, page_no: int, item_no: int, op: dict):
+        if not self.is_browser and self.has_device_service("set_value_bin"):
+            data = msgpack_encode(to_binary_value(op))
+            _LOGGER.debug(f"async_send_value: set_value_bin: {page_no}, {item_no}, {len(json.dumps(op))} -> {len(data)} bytes")
+            await self.async_call_device_service("set_value_bin", {
+                "page": page_no, "item": item_no, "size": len(data), "data": bytes_to_ints(data)
+            })
+        else:
+            await self.async_call_device_service("set_value", {
+                "page": page_no, "item": item_no, "json_value": json.dumps(op)
+            })
+
+    async def async_send_value_batch(self, ops: list):
+        binary = not self.is_browser and self.has_device_service("set_values_bin")
+        if len(ops) < 2 or not (binary or (not self.is_browser and self.has_device_service("set_values"))):
+            for (page_no, item_no, op) in ops:
+                await self.async_send_value(page_no, item_no, op)
+            return
+        async def flush(batch):
+            if binary:
+                data = msgpack_encode({"v": batch})
+                _LOGGER.debug(f"async_send_value_batch: set_values_bin: {len(batch)} items, {len(data)} bytes")
+                await self.async_call_device_service("set_values_bin", {"size": len(data), "data": bytes_to_ints(data)})
+            else:
+                _LOGGER.debug(f"async_send_value_batch: set_values: {len(batch)} items")
+                await self.async_call_device_service("set_values", {"json_value": json.dumps({"v": batch})})
+        batch = []
+        size = 0
+        for (page_no, item_no, op) in ops:
+            value = [page_no, item_no, to_binary_value(op) if binary else op]
+            value_size = len(msgpack_encode(value)) if binary else len(json.dumps(value))
+            if batch and size + value_size > SET_VALUES_MAX_SIZE:
+                await flush(batch)
+                batch = []
+                size = 0
+            batch.append(value)
+            size += value_size
+        if batch:
+            await flush(batch)
+
     async def async_send_values(self, entity_id: str | None = None, page: int | None = None):
-        for (page_no, _, item_no, item) in self._dashboard_items():
-            if (entity_id is None or entity_id in self._pick_entity_ids(item)) and (page is None or page == page_no):
-                type_ = self._g(item, "type", self._g(item, "layout", "button"))
-                if op := await self.async_prepare_data(type_, item):
-                    _LOGGER.debug(f"async_send_values: set_value: {page_no}, {item_no}, {op}")
-                    await self.async_call_device_service("set_value", {
-                        "page": page_no, "item": item_no, "json_value": json.dumps(op)
-                    })
+        ops = []
+        packs = None
+        if self._glyphs_enabled and not self.is_browser and self.has_device_service("set_glyph_pack"):
+            # New glyphs are collected while preparing and sent ahead of the values
+            packs = {}
+        token = _GLYPHS_PACK.set(packs)
+        try:
+            for (page_no, _, item_no, item) in self._dashboard_items():
+                if (entity_id is None or entity_id in self._pick_entity_ids(item)) and (page is None or page == page_no):
+                    type_ = self._g(item, "type", self._g(item, "layout", "button"))
+                    if op := await self.async_prepare_data(type_, item):
+                        _LOGGER.debug(f"async_send_values: set_value: {page_no}, {item_no}, {op}")
+                        ops.append((page_no, item_no, op))
+        finally:
+            _GLYPHS_PACK.reset(token)
+        await self.async_send_glyph_packs(packs)
+        await self.async_send_value_batch(ops)
+
+    async def async_send_blob(self, service: str, blob: bytes, extra: dict = {}):
+        data = bytes_to_ints(blob)
+        offset = 0
+        while offset < len(data):
+            await self.async_call_device_service(service, {
+                "data": data[offset:(offset + SET_DATA_BATCH)], 
+                "offset": offset, "size": len(data),
+                **extra,
+            })
+            offset += SET_DATA_BATCH
+
+    async def async_send_glyph_packs(self, packs: dict | None):
+        for size, glyphs in (packs or {}).items():
+            blob = pack_glyphs(size, glyphs)
+            _LOGGER.debug(f"async_send_glyph_packs: {size}: {len(glyphs)} glyphs, {len(blob)} bytes")
+            await self.async_send_blob("set_glyph_pack", blob)
+
+    async def async_send_text_glyphs(self, font: int, height: int, base: int, codes: list):
+        path = self._g(self._g(self._dashboard or {}, "theme", {}), "text_font")
+        if not path or not codes or not self.has_device_service("set_text_glyphs"):
+            _LOGGER.debug(f"async_send_text_glyphs: no text_font, {len(codes)} glyphs not sent")
+            return
+        path = self.hass.config.path(path)
+        if not self._text_glyphs or self._text_glyphs[0] != path:
+            self._text_glyphs = (path, TextGlyphProvider(path))
+        blob = await self.hass.async_add_executor_job(self._text_glyphs[1].get_glyphs, height, base, codes)
+        await self.async_send_blob("set_text_glyphs", blob, {"font": font})
 
     async def async_prepare_button(self, item: dict):
         result = {
@@ -377,7 +539,8 @@ class Coordinator(DataUpdateCoordinator):
         for key in ("left", "right"):
             if key in item and "icon" in item[key]:
                 result[key] = {
-                    "icon": self._mdi_font.get_icon_value(icon_from_state(self._g(item[key], "icon"), None), 30),
+                    # Recorded like item icons, the device keeps them in the same fonts
+                    "icon": self._icon_value(icon_from_state(self._g(item[key], "icon"), None), 30),
                 }
         return result
     
@@ -474,8 +637,84 @@ class Coordinator(DataUpdateCoordinator):
             else:
                     yield (x, y, w, h, item_data)
 
+    def _vector_icons(self) -> bool:
+        # Opt-in: outlines rasterized anti-aliased on the device instead of 1bpp bitmaps
+        return bool(self._g(self._g(self._dashboard or {}, "theme", {}), "vector_icons", False))
+
+    def _icon_value(self, icon: str, size: int) -> dict:
+        value = self._mdi_font.get_icon_value(icon, size, self._glyphs_max_fmt, self._vector_icons())
+        if (value["name"], size) in self._glyphs_static:
+            # Compiled into the firmware, the device matches it by name and size
+            if self._glyphs_enabled:
+                self._glyphs_sent[(value["name"], size)] = value["h"]
+            return {k: v for k, v in value.items() if k != "data"}
+        if not self._glyphs_enabled or _GLYPHS_BYPASS.get():
+            if self._glyphs_enabled:
+                self._glyphs_sent[(value["name"], size)] = value["h"]
+            return value
+        key = (value["name"], size)
+        if self._glyphs_sent.get(key) == value["h"]:
+            # Already on the device: name and hash only
+            return {k: v for k, v in value.items() if k != "data"}
+        self._glyphs_sent[key] = value["h"]
+        if (packs := _GLYPHS_PACK.get()) is not None and len(value["name"].encode("utf-8")) < 0x100:
+            packs.setdefault(size, []).append((value["name"], value["h"], base64.standard_b64decode(value["data"])))
+            return {k: v for k, v in value.items() if k != "data"}
+        return value
+
+    def _glyphs_digest(self, record: dict | None = None) -> int:
+        result = 0
+        for (name, size), h in (self._glyphs_sent if record is None else record).items():
+            result ^= fnv1a32(f"{name}:{size}:{h}".encode("utf-8"))
+        return result
+
+    def _glyphs_record(self, records: str) -> dict:
+        """ "size:hash:name;..." of the glyphs event back into the _glyphs_sent form """
+        result = {}
+        for record in records.split(";"):
+            size, _, rest = record.partition(":")
+            h, _, name = rest.partition(":")
+            if size.isdigit() and h.isdigit() and name:
+                result[(name, int(size))] = int(h)
+        return result
+
+    def _reset_glyphs(self):
+        # The record of sent glyphs stays, the device keeps its glyphs while it is only disconnected
+        self._glyphs_enabled = False
+        self._glyphs_max_fmt = 1
+        self._glyphs_static = set()
+
+    async def async_sync_glyphs(self):
+        """ Compares the device glyph set with the sent record, the device is reset on mismatch """
+        self._glyphs_enabled = False
+        if self.is_browser or not self.has_device_service("sync_glyphs"):
+            return
+        for reset in (False, True):
+            self._glyphs_future = self.hass.loop.create_future()
+            await self.async_call_device_service("sync_glyphs", {"reset": reset})
+            try:
+                digest, count, records = await asyncio.wait_for(self._glyphs_future, GLYPHS_SYNC_TIMEOUT)
+            except asyncio.TimeoutError:
+                _LOGGER.warning(f"async_sync_glyphs: no response from the device")
+                return
+            finally:
+                self._glyphs_future = None
+            if reset or count == 0:
+                self._glyphs_sent = {}
+            if digest != self._glyphs_digest():
+                # After a reconnect or a restart of Home Assistant take over what the device holds
+                record = self._glyphs_record(records)
+                if self._glyphs_digest(record) == digest:
+                    self._glyphs_sent = record
+            if digest == self._glyphs_digest():
+                _LOGGER.debug(f"async_sync_glyphs: in sync, {len(self._glyphs_sent)} glyphs")
+                self._glyphs_enabled = True
+                return
+            _LOGGER.debug(f"async_sync_glyphs: digest mismatch: {digest}")
+
     async def async_send_dashboard(self):
         self._on_entity_state_handler = self._disable_listener(self._on_entity_state_handler)
+        await self.async_sync_glyphs()
         name = self._config.get(CONF_DASHBOARD)
         if not name:
             name = "default"
@@ -568,8 +807,7 @@ class Coordinator(DataUpdateCoordinator):
                 "value": state.state,
             })
         if domain in IMAGE_DOMAINS:
-            size, data = await self.async_picture_from_state(entity_id, state, self.get_more_page_image_scale())
-            if size and data:
+            if size := await self.async_picture_size(entity_id, self.get_more_page_image_scale()):
                 features.append({
                     "type": "image", 
                     "width": size[0], 
@@ -618,6 +856,14 @@ class Coordinator(DataUpdateCoordinator):
         _LOGGER.warning(f"call_device_service: service not found: {name}")
         return False
 
+    def has_device_service(self, name: str) -> bool:
+        if not self._entry_data:
+            return False
+        for _, service in self._entry_data.services.items():
+            if service.name == name:
+                return True
+        return False
+
     def is_device_connected(self) -> bool:
         if self.is_browser:
             return True
@@ -704,6 +950,19 @@ class Coordinator(DataUpdateCoordinator):
         
         if type_ == "page":
             await self._async_update_state({"page": page})
+        if type_ == "glyphs":
+            self._glyphs_max_fmt = int(event.get("fmt", 1))
+            # "size:name,name;size:name" of the icons compiled into the firmware
+            self._glyphs_static = set()
+            for group in event.get("static", "").split(";"):
+                size, _, names = group.partition(":")
+                if size.isdigit():
+                    self._glyphs_static.update((name, int(size)) for name in names.split(",") if name)
+            if self._glyphs_future and not self._glyphs_future.done():
+                self._glyphs_future.set_result((int(event.get("digest", 0)), int(event.get("count", 0)), event.get("glyphs", "")))
+        if type_ == "text_glyphs":
+            codes = [int(c) for c in event.get("codes", "").split(",") if c]
+            await self.async_send_text_glyphs(int(event.get("font", 0)), int(event.get("height", 0)), int(event.get("base", 0)), codes)
         if type_ == "more":
             visible = event.get("visible") == "1"
             changed = self.data.get("more_page", False) != visible
@@ -716,6 +975,9 @@ class Coordinator(DataUpdateCoordinator):
                 btn = btns[item]
                 await self.async_exec_action(self._g(btn, "on_tap" if type_ == "button" else "on_long_tap"), btn)
         le = event.get("le") == "1"
+        chunk = int(event.get("chunk", 0))
+        jpeg = event.get("jpeg") == "1"
+        frame = int(event.get("frame", 0))
         if item_def := self._get_item_def(page, item):
             item_type_ = self._g(item_def, "type", self._g(item_def, "layout", "button"))
             if type_ == "click":
@@ -728,20 +990,34 @@ class Coordinator(DataUpdateCoordinator):
                 if not action and item_type_ == "tile":
                     action = { "more": True }
                 await self.async_exec_action(action, item_def)
+            if type_ == "glyph_miss":
+                token = _GLYPHS_BYPASS.set(True)
+                try:
+                    op = await self.async_prepare_data(item_type_, item_def)
+                finally:
+                    _GLYPHS_BYPASS.reset(token)
+                if op:
+                    await self.async_send_value(page, item, op)
             if type_ == "data_request":
                 entity_id_ = self._g(item_def, "entity_id")
                 scale = int(self._g(item_def, "scale", PICTURE_DEF_SCALE_ITEM) * self.get_theme_scale())
-                await self.async_send_picture_data("set_data", entity_id_, scale, le, lambda: {"item": item, "page": page})
+                await self.async_send_picture_data(
+                    "set_data", entity_id_, scale, le, lambda: {"item": item, "page": page}, chunk, jpeg,
+                    fmt=self._picture_format(item_def), frame_key=(page, item), frame=frame
+                )
         if entity_id and op:
             if type_ == "change":
                 value = int(event.get("value", 0))
                 await self.async_exec_change_action(entity_id, op, value)
             if type_ == "data_request":
-                await self.async_send_picture_data("set_data_more", entity_id, self.get_more_page_image_scale(), le, lambda: {})
+                await self.async_send_picture_data("set_data_more", entity_id, self.get_more_page_image_scale(), le, lambda: {}, chunk, jpeg)
 
     def _connect_to_esphome_device(self, entry_data):
         def _on_device_update():
             _LOGGER.debug(f"_on_device_update: {entry_data.available}")
+            if not entry_data.available:
+                self._reset_glyphs()
+                self._frames = {}
             if entry_data.available:
                 self.hass.async_create_task(self.async_send_dashboard())
             self.hass.async_create_task(self._async_update_state({"connected": self.is_device_connected()}))
@@ -0,0 +1,103 @@
+import struct, re
+
+_COLOR_KEYS = ("col", "badge")
+_COLOR_RE = re.compile(r"^#[0-9a-fA-F]{6}$")
+
+def msgpack_encode(value) -> bytes:
+    result = bytearray()
+    _pack(value, result)
+    return bytes(result)
+
+def _pack(value, out: bytearray):
+    if value is None:
+        out.append(0xc0)
+    elif isinstance(value, bool):
+        out.append(0xc3 if value else 0xc2)
+    elif isinstance(value, int):
+        _pack_int(value, out)
+    elif isinstance(value, float):
+        out.append(0xcb)
+        out.extend(struct.pack(">d", value))
+    elif isinstance(value, str):
+        data = value.encode("utf-8")
+        l = len(data)
+        if l < 32:
+            out.append(0xa0 | l)
+        elif l < 0x100:
+            out.extend(struct.pack(">BB", 0xd9, l))
+        elif l < 0x10000:
+            out.extend(struct.pack(">BH", 0xda, l))
+        else:
+            out.extend(struct.pack(">BI", 0xdb, l))
+        out.extend(data)
+    elif isinstance(value, (list, tuple)):
+        l = len(value)
+        if l < 16:
+            out.append(0x90 | l)
+        elif l < 0x10000:
+            out.extend(struct.pack(">BH", 0xdc, l))
+        else:
+            out.extend(struct.pack(">BI", 0xdd, l))
+        for item in value:
+            _pack(item, out)
+    elif isinstance(value, dict):
+        l = len(value)
+        if l < 16:
+            out.append(0x80 | l)
+        elif l < 0x10000:
+            out.extend(struct.pack(">BH", 0xde, l))
+        else:
+            out.extend(struct.pack(">BI", 0xdf, l))
+        for key, item in value.items():
+            _pack(str(key), out)
+            _pack(item, out)
+    else:
+        _pack(str(value), out)
+
+def _pack_int(value: int, out: bytearray):
+    if 0 <= value < 0x80:
+        out.append(value)
+    elif -32 <= value < 0:
+        out.append(value & 0xff)
+    elif 0 <= value < 0x100:
+        out.extend(struct.pack(">BB", 0xcc, value))
+    elif 0 <= value < 0x10000:
+        out.extend(struct.pack(">BH", 0xcd, value))
+    elif 0 <= value < 0x100000000:
+        out.extend(struct.pack(">BI", 0xce, value))
+    elif value >= 0:
+        out.extend(struct.pack(">BQ", 0xcf, value))
+    elif value >= -0x80:
+        out.extend(struct.pack(">Bb", 0xd0, value))
+    elif value >= -0x8000:
+        out.extend(struct.pack(">Bh", 0xd1, value))
+    elif value >= -0x80000000:
+        out.extend(struct.pack(">Bi", 0xd2, value))
+    else:
+        out.extend(struct.pack(">Bq", 0xd3, value))
+
+def to_binary_value(value):
+    """ Pre-parses "#rrggbb" colors into 0xRRGGBB integers, the device accepts both """
+    if isinstance(value, list):
+        return [to_binary_value(item) for item in value]
+    if isinstance(value, dict):
+        result = {}
+        for key, item in value.items():
+            if key in _COLOR_KEYS and isinstance(item, str) and _COLOR_RE.match(item):
+                result[key] = int(item[1:], 16)
+            else:
+                result[key] = to_binary_value(item)
+        return result
+    return value
+
+def bytes_to_ints(data: bytes) -> list:
+    """ Packs bytes into native (little endian) int32 values for the int[] API transport """
+    padded = data + bytes((-len(data)) % 4)
+    return list(struct.unpack(f"<{len(padded) // 4}i", padded))
+
+def fnv1a32(data: bytes) -> int:
+    """ 32-bit FNV-1a, matches fnv1a_() on the device """
+    result = 0x811c9dc5
+    for b in data:
+        result = ((result ^ b) * 0x01000193) & 0xffffffff
+    return result
@@ -2,7 +2,9 @@ import json, pathlib, base64, logging
 from PIL import ImageFont
 from dataclasses import dataclass
 from .icon import DEFAULT_ICON
-from .compress import rle_encode
+from .compress import rle_encode, bitrun_encode
+from .outline import TtfOutlines, encode_outline
+from ..encoding import fnv1a32
 
 _LOGGER = logging.getLogger(__name__)
 
@@ -29,6 +31,7 @@ class GlyphProvider:
 
     def init(self):
         self._glyph_map = self._load_meta_json()
+        self._outlines = TtfOutlines(pathlib.Path(locate_dir()).joinpath("mdi-webfont.ttf"))
 
     def _load_meta_json(self) -> dict:
         path = pathlib.Path(locate_dir()).joinpath("meta.json")
@@ -59,21 +62,45 @@ class GlyphProvider:
         _, (offset_x, offset_y) = font.font.getsize(glyph)
         return offset_x, offset_y
     
-    def get_icon_value(self, icon: str, size: int) -> dict:
+    def _get_outline_value(self, icon: str, size: int) -> list | None:
+        """ Box for this size (as rendered by PIL) and the outline normalized to it, rasterized by the device """
+        glyph = self._glyph_map.get(icon)
+        contours = self._outlines.get_contours(ord(glyph))
+        if not contours:
+            return None
+        left, top, right, bottom = self._load_ttf_font(size).getbbox(glyph)
+        box = [left, top, right - left, bottom - top]
+        if min(box) < 0 or max(box) > 0xff:
+            return None
+        return box + [3] + encode_outline(contours)
+
+    def get_icon_value(self, icon: str, size: int, max_fmt: int = 1, vector: bool = False) -> dict:
         default_icon = False
         if icon not in self._glyph_map:
             icon = DEFAULT_ICON
             default_icon = True
+        if vector and max_fmt >= 3 and (data := self._get_outline_value(icon, size)):
+            _LOGGER.debug(f"get_icon_value: {icon}, outline: {len(data)}")
+            return {
+                "name": icon, "size": size, 
+                "data": base64.standard_b64encode(bytearray(data)).decode("ascii"), 
+                "def": default_icon,
+                "h": fnv1a32(bytes(data)),
+            }
         info = self.get_glyph(icon, size)
-        rle_data = rle_encode(info.data)
-        use_rle = len(rle_data) < len(info.data)
-        # if use_rle:
-        _LOGGER.debug(f"get_icon_value: {icon}, {use_rle}, {len(info.data)} / {len(rle_data)}")
-        data = [info.x, info.y, info.width, info.height, 1 if use_rle else 0] + (rle_data if use_rle else info.data)
+        # Smallest of raw (0), byte-pair RLE (1) and bit runs (2) the device can decode
+        encoded = [info.data, rle_encode(info.data)]
+        if max_fmt >= 2:
+            encoded.append(bitrun_encode(info.data, info.width, info.height))
+        fmt = min(range(len(encoded)), key=lambda f: len(encoded[f]))
+        _LOGGER.debug(f"get_icon_value: {icon}, {fmt}, {' / '.join(str(len(e)) for e in encoded)}")
+        data = [info.x, info.y, info.width, info.height, fmt] + encoded[fmt]
         return {
             "name": icon, "size": size, 
             "data": base64.standard_b64encode(bytearray(data)).decode("ascii"), 
-            "def": default_icon
+            "def": default_icon,
+            # Content hash of the decoded glyph, independent of the encoding
+            "h": fnv1a32(bytes([info.x, info.y, info.width, info.height] + info.data)),
         }
 
     def get_glyph(self, icon: str, size: int) -> GlyphInfo | None:
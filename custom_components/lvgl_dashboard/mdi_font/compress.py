@@ -1,5 +1,5 @@
 from itertools import repeat, compress, groupby
-import base64, logging
+import base64, logging, struct
 
 _LOGGER = logging.getLogger(__name__)
 
@@ -21,6 +21,49 @@ def rle_encode(iterable: list) -> list:
         result.extend([l, k])
     return result
 
+def _varint(value: int, out: list):
+    while value >= 0x80:
+        out.append((value & 0x7f) | 0x80)
+        value >>= 7
+    out.append(value)
+
+def bitrun_encode(data: list, width: int, height: int) -> list:
+    """
+    Row by row over the MSB first bitstream: the byte length of the row, then alternating 0/1 run lengths
+    (starting with 0), all as varints. Runs restart at every row, the trailing 0 run of a row is implied.
+    """
+    result = []
+    for row in range(height):
+        runs = []
+        current = 0
+        run = 0
+        for pos in range(row * width, (row + 1) * width):
+            bit = (data[pos // 8] >> (7 - pos % 8)) & 1
+            if bit != current:
+                _varint(run, runs)
+                current = bit
+                run = 0
+            run += 1
+        if current:
+            _varint(run, runs)
+        _varint(len(runs), result)
+        result.extend(runs)
+    return result
+
+def pack_glyphs(size: int, glyphs: list) -> bytes:
+    """
+    set_glyph_pack blob: font size, glyph count, then per glyph
+    name length, name, hash, bitmap size, 5 byte header and the bitmap (all little endian)
+    """
+    result = bytearray(struct.pack("<HH", size, len(glyphs)))
+    for (name, h, data) in glyphs:
+        name_ = name.encode("utf-8")
+        result.append(len(name_))
+        result.extend(name_)
+        result.extend(struct.pack("<IH", h, len(data) - 5))
+        result.extend(data)
+    return bytes(result)
+
 def pack_data(prefix: bytes, data: bytes) -> str:
     rle_data = rle_encode(data)
     use_rle = len(rle_data) < len(data)
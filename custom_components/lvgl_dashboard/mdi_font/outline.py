@@ -0,0 +1,127 @@
+import struct, pathlib, logging
+
+_LOGGER = logging.getLogger(__name__)
+
+# Outline coordinates are normalized to the glyph box, 0..OUTLINE_UNITS
+OUTLINE_UNITS = 4095
+
+def _zigzag(value: int) -> int:
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+def _varint(value: int, out: list):
+    while value >= 0x80:
+        out.append((value & 0x7f) | 0x80)
+        value >>= 7
+    out.append(value)
+
+class TtfOutlines:
+    """
+    Minimal TrueType reader: quadratic contours of simple glyphs by code point (cmap format 12)
+    """
+
+    def __init__(self, path: pathlib.Path) -> None:
+        self._data = path.read_bytes()
+        self._tables = {}
+        num_tables, = struct.unpack_from(">H", self._data, 4)
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack_from(">4sIII", self._data, 12 + i * 16)
+            self._tables[tag.decode("latin-1")] = (offset, length)
+        head, _ = self._tables["head"]
+        self.units_per_em, = struct.unpack_from(">H", self._data, head + 18)
+        self._long_loca = struct.unpack_from(">h", self._data, head + 50)[0] == 1
+        self._cmap = self._load_cmap()
+
+    def _load_cmap(self) -> list:
+        cmap, _ = self._tables["cmap"]
+        num_tables, = struct.unpack_from(">H", self._data, cmap + 2)
+        for i in range(num_tables):
+            _, _, offset = struct.unpack_from(">HHI", self._data, cmap + 4 + i * 8)
+            if struct.unpack_from(">H", self._data, cmap + offset)[0] == 12:
+                num_groups, = struct.unpack_from(">I", self._data, cmap + offset + 12)
+                return [
+                    struct.unpack_from(">III", self._data, cmap + offset + 16 + j * 12)
+                    for j in range(num_groups)
+                ]
+        return []
+
+    def _glyph_index(self, codepoint: int) -> int:
+        for (start, end, glyph) in self._cmap:
+            if start <= codepoint <= end:
+                return glyph + codepoint - start
+        return 0
+
+    def _glyph_range(self, index: int) -> tuple:
+        loca, _ = self._tables["loca"]
+        if self._long_loca:
+            start, end = struct.unpack_from(">II", self._data, loca + index * 4)
+        else:
+            start, end = [v * 2 for v in struct.unpack_from(">HH", self._data, loca + index * 2)]
+        glyf, _ = self._tables["glyf"]
+        return glyf + start, end - start
+
+    def get_contours(self, codepoint: int) -> list | None:
+        """ Contours of (x, y, on_curve) in font units, y up. None for empty or composite glyphs """
+        offset, length = self._glyph_range(self._glyph_index(codepoint))
+        if length == 0:
+            return None
+        num_contours, = struct.unpack_from(">h", self._data, offset)
+        if num_contours <= 0:
+            return None
+        pos = offset + 10
+        end_points = struct.unpack_from(f">{num_contours}H", self._data, pos)
+        pos += num_contours * 2
+        instructions, = struct.unpack_from(">H", self._data, pos)
+        pos += 2 + instructions
+        num_points = end_points[-1] + 1
+        flags = []
+        while len(flags) < num_points:
+            flag = self._data[pos]
+            pos += 1
+            flags.append(flag)
+            if flag & 0x08:
+                flags.extend([flag] * self._data[pos])
+                pos += 1
+        coords = []
+        for (short, same) in ((0x02, 0x10), (0x04, 0x20)):
+            value = 0
+            values = []
+            for flag in flags[:num_points]:
+                if flag & short:
+                    delta = self._data[pos]
+                    pos += 1
+                    value += delta if flag & same else -delta
+                elif not flag & same:
+                    value += struct.unpack_from(">h", self._data, pos)[0]
+                    pos += 2
+                values.append(value)
+            coords.append(values)
+        result = []
+        start = 0
+        for end in end_points:
+            result.append([(coords[0][i], coords[1][i], flags[i] & 0x01) for i in range(start, end + 1)])
+            start = end + 1
+        return result
+
+def encode_outline(contours: list) -> list:
+    """
+    Contours normalized to the bounding box (0..OUTLINE_UNITS, y down) as varints:
+    contour count, then per contour the point count and per point zigzag(dx) << 1 | on_curve, zigzag(dy),
+    deltas continue across contours
+    """
+    xs = [p[0] for c in contours for p in c]
+    ys = [p[1] for c in contours for p in c]
+    x_min, x_max, y_min, y_max = min(xs), max(xs), min(ys), max(ys)
+    w = max(x_max - x_min, 1)
+    h = max(y_max - y_min, 1)
+    result = []
+    _varint(len(contours), result)
+    px = py = 0
+    for contour in contours:
+        _varint(len(contour), result)
+        for (x, y, on) in contour:
+            nx = round((x - x_min) * OUTLINE_UNITS / w)
+            ny = round((y_max - y) * OUTLINE_UNITS / h)
+            _varint((_zigzag(nx - px) << 1) | (1 if on else 0), result)
+            _varint(_zigzag(ny - py), result)
+            px, py = nx, ny
+    return result
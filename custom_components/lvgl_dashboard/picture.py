@@ -4,9 +4,15 @@ from homeassistant.components import image
 
 from PIL import Image
 import io, logging, math, struct
+import numpy as np
 
 _LOGGER = logging.getLogger(__name__)
 
+PICTURE_JPEG_QUALITY = 85
+# Frame deltas: changes are searched in square tiles, the whole frame is resent above this share of its size
+PICTURE_DELTA_TILE = 16
+PICTURE_DELTA_MAX = 0.5
+
 def bytes_to_scaled(data: bytes, size: int) -> bytes:
     with io.BytesIO(data) as f, io.BytesIO() as fout:
         image = Image.open(f, formats=["JPEG", "PNG"])
@@ -15,6 +21,23 @@ def bytes_to_scaled(data: bytes, size: int) -> bytes:
         return fout.getvalue()
 
 
+def thumbnail_size(width: int, height: int, size: int) -> tuple:
+    """ Size Image.thumbnail((size, size)) scales to, computed without touching the pixels """
+    if width <= size and height <= size:
+        return (width, height)
+    aspect = width / height
+    def round_aspect(number: float, key) -> int:
+        return max(min(math.floor(number), math.ceil(number), key=key), 1)
+    if aspect <= 1:
+        return (round_aspect(size * aspect, key=lambda n: abs(aspect - n / size)), size)
+    return (size, round_aspect(size / aspect, key=lambda n: 0 if n == 0 else abs(aspect - size / n)))
+
+def bytes_to_size(data: bytes, content_type: str, size: int) -> tuple:
+    """ Size of the converted picture, all conversions thumbnail to it. Only the header is read """
+    with io.BytesIO(data) as f:
+        image = Image.open(f, formats=["JPEG", "PNG"])
+        return thumbnail_size(image.width, image.height, size)
+
 def bytes_to_565_ints(data: bytes, content_type: str, size: int, le: bool = False):
     with io.BytesIO(data) as f:
         image = Image.open(f, formats=["JPEG", "PNG"])
@@ -41,6 +64,121 @@ def bytes_to_565_ints(data: bytes, content_type: str, size: int, le: bool = Fals
         _LOGGER.debug(f"bytes_to_565: int32s {image.width}x{image.height} ~ {len(result)}, {le}")
         return ((image.width, image.height), result)
 
+def bytes_to_565(data: bytes, content_type: str, size: int, le: bool = False):
+    """ RGB565 pixels as bytes in the device byte order, for the set_data_b64 transport """
+    with io.BytesIO(data) as f:
+        image = Image.open(f, formats=["JPEG", "PNG"])
+        image.thumbnail((size, size))
+        pixels = np.asarray(image.convert("RGB"), dtype=np.uint16)
+        rgb565 = ((pixels[..., 0] >> 3) << 11) | ((pixels[..., 1] >> 2) << 5) | (pixels[..., 2] >> 3)
+        result = rgb565.astype("<u2" if le else ">u2").tobytes()
+        _LOGGER.debug(f"bytes_to_565: {image.width}x{image.height} ~ {len(result)}, {content_type}, {le}")
+        return ((image.width, image.height), result)
+
+def bytes_to_jpeg(data: bytes, content_type: str, size: int, le: bool = False):
+    """ Baseline JPEG for the device decoder, the original when it already fits """
+    with io.BytesIO(data) as f, io.BytesIO() as fout:
+        image = Image.open(f, formats=["JPEG", "PNG"])
+        if image.format == "JPEG" and max(image.size) <= size and not image.info.get("progressive"):
+            return (image.size, data)
+        image.thumbnail((size, size))
+        image.convert("RGB").save(fout, "JPEG", quality=PICTURE_JPEG_QUALITY)
+        _LOGGER.debug(f"bytes_to_jpeg: {image.width}x{image.height} ~ {fout.tell()}, {content_type}")
+        return ((image.width, image.height), fout.getvalue())
+
+def indexed_bpp(colors: int) -> int:
+    """ Smallest LVGL indexed depth (1, 2, 4 or 8 bits) holding the palette """
+    for bpp in (1, 2, 4):
+        if colors <= (1 << bpp):
+            return bpp
+    return 8
+
+def bytes_to_indexed(data: bytes, content_type: str, size: int, le: bool = False, colors: int = 16):
+    """ LV_IMG_CF_INDEXED_xBIT: B,G,R,A palette of 2^bpp entries, then byte aligned rows, first pixel in the high bits """
+    bpp = indexed_bpp(colors)
+    with io.BytesIO(data) as f:
+        image = Image.open(f, formats=["JPEG", "PNG"])
+        image.thumbnail((size, size))
+        indexed = image.convert("RGB").quantize(min(colors, 1 << bpp))
+        palette = np.zeros((1 << bpp, 4), dtype=np.uint8)
+        rgb = np.frombuffer(bytes(indexed.getpalette()[:(1 << bpp) * 3]), dtype=np.uint8).reshape(-1, 3)
+        palette[:len(rgb), 0:3] = rgb[:, ::-1]
+        palette[:, 3] = 0xff
+        pixels = np.asarray(indexed, dtype=np.uint8)
+        per_byte = 8 // bpp
+        width = (image.width + per_byte - 1) // per_byte * per_byte
+        pixels = np.pad(pixels, ((0, 0), (0, width - image.width))).reshape(image.height, -1, per_byte)
+        shifts = np.arange(8 - bpp, -1, -bpp, dtype=np.uint8)
+        rows = np.bitwise_or.reduce(pixels << shifts, axis=2).astype(np.uint8)
+        result = palette.tobytes() + rows.tobytes()
+        _LOGGER.debug(f"bytes_to_indexed: {image.width}x{image.height} ~ {len(result)}, {content_type}, {bpp}")
+        return ((image.width, image.height), result)
+
+def bytes_to_alpha(data: bytes, content_type: str, size: int, le: bool = False):
+    """ LV_IMG_CF_ALPHA_8BIT: one opacity byte per pixel, from the alpha channel or the luminance """
+    with io.BytesIO(data) as f:
+        image = Image.open(f, formats=["JPEG", "PNG"])
+        image.thumbnail((size, size))
+        if "A" in image.getbands():
+            mask = image.getchannel("A")
+        else:
+            mask = image.convert("L")
+        result = mask.tobytes()
+        _LOGGER.debug(f"bytes_to_alpha: {image.width}x{image.height} ~ {len(result)}, {content_type}")
+        return ((image.width, image.height), result)
+
+def _rect_records(pixels, x: int, y: int, w: int, h: int, chunk: int) -> list:
+    """ set_data_rect records of a changed area: a fill when uniform, else pixel rows split to fit a chunk """
+    area = pixels[y:(y + h), x:(x + w)]
+    if (area == area[0, 0]).all():
+        return [struct.pack("<HHHHB", x, y, w, h, 1) + area[0, 0].tobytes()]
+    rows = max(1, (chunk - 9) // (w * 2))
+    return [
+        struct.pack("<HHHHB", x, y + row, w, min(rows, h - row), 0) + area[row:(row + rows)].tobytes()
+        for row in range(0, h, rows)
+    ]
+
+def frame_delta(old: bytes, new: bytes, size: tuple, chunk: int) -> list | None:
+    """
+    set_data_rect blobs turning the old RGB565 frame into the new one, each up to chunk bytes.
+    Changed tiles are merged into runs per tile row and cropped to the changed pixels.
+    None when the delta would not be worth it
+    """
+    width, height = size
+    if len(old) != len(new) or len(new) != width * height * 2:
+        return None
+    before = np.frombuffer(old, dtype=np.uint16).reshape(height, width)
+    after = np.frombuffer(new, dtype=np.uint16).reshape(height, width)
+    changed = before != after
+    tile = PICTURE_DELTA_TILE
+    records = []
+    for y in range(0, height, tile):
+        band = changed[y:(y + tile)]
+        tiles = np.logical_or.reduceat(band.any(axis=0), range(0, width, tile))
+        start = None
+        for i, dirty in enumerate(list(tiles) + [False]):
+            if dirty and start is None:
+                start = i
+            elif not dirty and start is not None:
+                region = band[:, (start * tile):min(i * tile, width)]
+                rows = np.flatnonzero(region.any(axis=1))
+                cols = np.flatnonzero(region.any(axis=0))
+                records.extend(_rect_records(
+                    after, start * tile + int(cols[0]), y + int(rows[0]),
+                    int(cols[-1] - cols[0]) + 1, int(rows[-1] - rows[0]) + 1, chunk
+                ))
+                start = None
+    if sum(len(r) for r in records) > PICTURE_DELTA_MAX * len(new):
+        return None
+    blobs = []
+    for record in records:
+        if blobs and len(blobs[-1]) + len(record) <= chunk:
+            blobs[-1] += record
+        else:
+            blobs.append(record)
+    _LOGGER.debug(f"frame_delta: {width}x{height}, {len(records)} rects, {sum(len(b) for b in blobs)} of {len(new)}")
+    return blobs
+
 def get_entity_by_entity_id(hass: HomeAssistant, entity_id: str) -> image.ImageEntity | None:
     component = hass.data.get(image.const.DATA_COMPONENT)
     if component is None:
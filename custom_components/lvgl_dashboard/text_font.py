@@ -0,0 +1,57 @@
+from PIL import ImageFont
+import logging, struct
+
+_LOGGER = logging.getLogger(__name__)
+
+TEXT_GLYPH_BPP = 4
+
+class TextGlyphProvider:
+    """
+    Renders text glyphs the device font lacks, sized to match the device font metrics
+    """
+
+    def __init__(self, path: str) -> None:
+        self._path = path
+        self._fonts = {}
+
+    def _font_for(self, height: int, base: int):
+        if (height, base) not in self._fonts:
+            # Same TTF at the same size gives the same line height as the compiled font
+            best = None
+            for size in range(4, 128):
+                font = ImageFont.truetype(self._path, size)
+                ascent, descent = font.getmetrics()
+                score = (abs(ascent + descent - height), abs(descent - base))
+                if best is None or score < best[0]:
+                    best = (score, font)
+                if ascent + descent > height + 2:
+                    break
+            self._fonts[(height, base)] = best[1]
+        return self._fonts[(height, base)]
+
+    def _glyph_record(self, font, code: int) -> bytes:
+        char = chr(code)
+        mask, (offset_x, offset_y) = font.getmask2(char, mode="L", anchor="ls")
+        width, height = mask.size
+        adv_w = round(font.getlength(char))
+        if width > 0xff or height > 0xff or not (-128 <= offset_x < 128) or not (-128 <= -(offset_y + height) < 128):
+            return b""
+        max_level = (1 << TEXT_GLYPH_BPP) - 1
+        data = bytearray((width * height * TEXT_GLYPH_BPP + 7) // 8)
+        pos = 0
+        for y in range(height):
+            for x in range(width):
+                value = (mask.getpixel((x, y)) * max_level + 127) // 255
+                data[pos // 8] |= value << (8 - TEXT_GLYPH_BPP - pos % 8)
+                pos += TEXT_GLYPH_BPP
+        # LVGL: ofs_y is from the baseline up to the bottom of the box
+        return struct.pack(
+            "<IBbbBBB", code, min(adv_w, 0xff), offset_x, -(offset_y + height), width, height, TEXT_GLYPH_BPP
+        ) + bytes(data)
+
+    def get_glyphs(self, height: int, base: int, codes: list) -> bytes:
+        """ set_text_glyphs blob: glyph count, reserved, then the glyph records """
+        font = self._font_for(height, base)
+        records = [r for r in (self._glyph_record(font, code) for code in codes) if r]
+        _LOGGER.debug(f"get_glyphs: {height}/{base}: {len(records)} of {len(codes)}")
+        return struct.pack("<HH", len(records), 0) + b"".join(records)